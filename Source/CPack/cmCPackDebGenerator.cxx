@@ -15,6 +15,8 @@
 #include "cmMakefile.h"
 #include "cmGeneratedFileStream.h"
 #include "cmCPackLog.h"
+#include "cmCryptoHash.h"
+#include "cmArchiveWrite.h"
 
 #include <cmsys/SystemTools.hxx>
 #include <cmsys/Glob.hxx>
@@ -491,39 +493,41 @@ int cmCPackDebGenerator::createDeb()
     { // the scope is needed for cmGeneratedFileStream
     cmGeneratedFileStream out(md5filename.c_str());
     std::vector<std::string>::const_iterator fileIt;
-//       std::string topLevelWithTrailingSlash = toplevel;
     std::string topLevelWithTrailingSlash =
         this->GetOption("CPACK_TEMPORARY_DIRECTORY");
     topLevelWithTrailingSlash += '/';
+    // compute the digests here rather than running one process per file
+    cmCryptoHashMD5 md5;
       for ( fileIt = packageFiles.begin();
             fileIt != packageFiles.end(); ++ fileIt )
       {
-      cmd = "\"";
-      cmd += cmakeExecutable;
-      cmd += "\" -E md5sum \"";
-      cmd += *fileIt;
-      cmd += "\"";
-      //std::string output;
-      //int retVal = -1;
-      res = cmSystemTools::RunSingleCommand(cmd.c_str(), &output,
-          &retval, toplevel.c_str(), this->GeneratorVerbose, 0);
+      std::string digest;
+      if(!cmSystemTools::FileIsDirectory(fileIt->c_str()))
+        {
+        digest = md5.HashFile(*fileIt);
+        }
+      if(digest.empty())
+        {
+        cmCPackLogger(cmCPackLog::LOG_WARNING,
+                      "Cannot compute md5sum of: " << *fileIt << std::endl);
+        continue;
+        }
       // debian md5sums entries are like this:
       // 014f3604694729f3bf19263bac599765  usr/bin/ccmake
       // thus strip the full path (with the trailing slash)
-      cmSystemTools::ReplaceString(output,
+      std::string fileName = *fileIt;
+      cmSystemTools::ReplaceString(fileName,
                                    topLevelWithTrailingSlash.c_str(), "");
-      out << output;
+      out << digest << "  " << fileName << "\n";
       }
     // each line contains a eol.
     // Do not end the md5sum file with yet another (invalid)
     }
 
-    cmd = "";
-    if (NULL != this->GetOption("CPACK_DEBIAN_FAKEROOT_EXECUTABLE"))
-      {
-      cmd = this->GetOption("CPACK_DEBIAN_FAKEROOT_EXECUTABLE");
-      }
-    cmd += cmake_tar + "tar czf control.tar.gz ./control ./md5sums";
+    // the files of control.tar.gz, relative to WDIR
+    std::vector<std::string> controlFiles;
+    controlFiles.push_back("control");
+    controlFiles.push_back("md5sums");
     const char* controlExtra =
       this->GetOption("CPACK_DEBIAN_PACKAGE_CONTROL_EXTRA");
   if( controlExtra )
@@ -542,28 +546,72 @@ int cmCPackDebGenerator::createDeb()
       if( cmsys::SystemTools::CopyFileIfDifferent(
             i->c_str(), localcopy.c_str()) )
         {
-        // debian is picky and need relative to ./ path in the tar.*
-        cmd += " ./";
-        cmd += filenamename;
+        controlFiles.push_back(filenamename);
         }
       }
     }
-  res = cmSystemTools::RunSingleCommand(cmd.c_str(), &output,
-      &retval, this->GetOption("WDIR"), this->GeneratorVerbose, 0);
 
-    if ( !res || retval )
+  if (NULL != this->GetOption("CPACK_DEBIAN_FAKEROOT_EXECUTABLE"))
     {
-    std::string tmpFile = this->GetOption("CPACK_TOPLEVEL_DIRECTORY");
-    tmpFile += "/Deb.log";
-    cmGeneratedFileStream ofs(tmpFile.c_str());
-    ofs << "# Run command: " << cmd << std::endl
-      << "# Working directory: " << toplevel << std::endl
-      << "# Output:" << std::endl
-      << output << std::endl;
-    cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem running tar command: "
-      << cmd << std::endl
-      << "Please check " << tmpFile << " for errors" << std::endl);
-    return 0;
+    // the archive must be created under fakeroot to get root ownership
+    cmd = this->GetOption("CPACK_DEBIAN_FAKEROOT_EXECUTABLE");
+    cmd += cmake_tar + "tar czf control.tar.gz";
+    for(std::vector<std::string>::const_iterator i = controlFiles.begin();
+        i != controlFiles.end(); ++i)
+      {
+      // debian is picky and need relative to ./ path in the tar.*
+      cmd += " ./";
+      cmd += *i;
+      }
+    res = cmSystemTools::RunSingleCommand(cmd.c_str(), &output,
+        &retval, this->GetOption("WDIR"), this->GeneratorVerbose, 0);
+
+      if ( !res || retval )
+      {
+      std::string tmpFile = this->GetOption("CPACK_TOPLEVEL_DIRECTORY");
+      tmpFile += "/Deb.log";
+      cmGeneratedFileStream ofs(tmpFile.c_str());
+      ofs << "# Run command: " << cmd << std::endl
+        << "# Working directory: " << toplevel << std::endl
+        << "# Output:" << std::endl
+        << output << std::endl;
+      cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem running tar command: "
+        << cmd << std::endl
+        << "Please check " << tmpFile << " for errors" << std::endl);
+      return 0;
+      }
+    }
+  else
+    {
+    // otherwise write the archive here rather than running cmake -E tar
+    std::string wdir = this->GetOption("WDIR");
+    std::string controlTar = wdir + "/control.tar.gz";
+    std::string error;
+    {
+    cmsys::ofstream fout(controlTar.c_str(), std::ios::out | std::ios::binary);
+    cmArchiveWrite ctl(fout, cmArchiveWrite::CompressGZip,
+                       cmArchiveWrite::TypeTAR);
+    for(std::vector<std::string>::const_iterator i = controlFiles.begin();
+        i != controlFiles.end() && ctl; ++i)
+      {
+      // debian is picky and need relative to ./ path in the tar.*
+      ctl.Add(wdir + "/" + *i, wdir.size() + 1, "./");
+      }
+    if(!fout)
+      {
+      error = "Cannot write file " + controlTar;
+      }
+    else if(!ctl)
+      {
+      error = ctl.GetError();
+      }
+    }
+    if(!error.empty())
+      {
+      cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem creating "
+        << controlTar << ": " << error << std::endl);
+      return 0;
+      }
     }
 
   // ar -r your-package-name.deb debian-binary control.tar.* data.tar.*
@@ -177,6 +177,156 @@ cmCTestWarningErrorFileLine[] = {
     { 0, 0, 0 }
 };
 
+//----------------------------------------------------------------------
+// Skip a bracket expression given the character after its '['.  Returns
+// the character after its ']', or 0 if it is not terminated.
+static const char* cmCTestBuildSkipBracket(const char* p)
+{
+  if(*p == '^')
+    {
+    ++p;
+    }
+  if(*p == ']' || *p == '-')
+    {
+    ++p;
+    }
+  while(*p && *p != ']')
+    {
+    ++p;
+    }
+  return *p ? p + 1 : 0;
+}
+
+//----------------------------------------------------------------------
+// Find the longest string of literal characters that every match of the
+// given regular expression contains.  Returns an empty string when there
+// is none, e.g. for an alternative at the top level.
+static std::string cmCTestBuildRequiredLiteral(const char* regex)
+{
+  std::string longest;
+  std::string current;
+  const char* p = regex;
+  while(*p)
+    {
+    char c = *p++;
+    bool literal = false;
+    switch(c)
+      {
+      case '|':
+        return "";
+      case '\\':
+        if(!*p)
+          {
+          return "";
+          }
+        c = *p++;
+        literal = true;
+        break;
+      case '[':
+        p = cmCTestBuildSkipBracket(p);
+        if(!p)
+          {
+          return "";
+          }
+        break;
+      case '(':
+        {
+        // Skip the group, its alternatives included.
+        int depth = 1;
+        while(*p && depth > 0)
+          {
+          if(*p == '[')
+            {
+            p = cmCTestBuildSkipBracket(p + 1);
+            if(!p)
+              {
+              return "";
+              }
+            continue;
+            }
+          if(*p == '\\' && p[1])
+            {
+            ++p;
+            }
+          else if(*p == '(')
+            {
+            ++depth;
+            }
+          else if(*p == ')')
+            {
+            --depth;
+            }
+          ++p;
+          }
+        if(depth > 0)
+          {
+          return "";
+          }
+        }
+        break;
+      case '.':
+      case '^':
+      case '$':
+      case '*':
+      case '+':
+      case '?':
+      case ')':
+        break;
+      default:
+        literal = true;
+        break;
+      }
+    if(literal)
+      {
+      if(*p == '*' || *p == '?')
+        {
+        // The character may not appear at all.
+        ++p;
+        }
+      else
+        {
+        current += c;
+        if(*p != '+')
+          {
+          continue;
+          }
+        ++p;
+        }
+      }
+    if(current.size() > longest.size())
+      {
+      longest = current;
+      }
+    current = "";
+    }
+  if(current.size() > longest.size())
+    {
+    longest = current;
+    }
+  return longest;
+}
+
+//----------------------------------------------------------------------
+cmCTestBuildHandler::cmCTestBuildLineRegex
+::cmCTestBuildLineRegex(const char* regex):
+  RegularExpression(regex),
+  RequiredLiteral(cmCTestBuildRequiredLiteral(regex))
+{
+}
+
+//----------------------------------------------------------------------
+bool cmCTestBuildHandler::cmCTestBuildLineRegex::Find(const char* line)
+{
+  // Patterns like "([^:]+): error" try every starting position of a line
+  // that does not match, so rule most lines out with a plain search.
+  if(!this->RequiredLiteral.empty() &&
+     !strstr(line, this->RequiredLiteral.c_str()))
+    {
+    return false;
+    }
+  return this->RegularExpression.find(line);
+}
+
 //----------------------------------------------------------------------
 cmCTestBuildHandler::cmCTestBuildHandler()
 {
@@ -410,7 +560,7 @@ int cmCTestBuildHandler::ProcessHandler()
     { \
     cmCTestLog(this->CTest, DEBUG, "Add " #strings ": " \
     << *it << std::endl); \
-    regexes.push_back(it->c_str()); \
+    regexes.push_back(cmCTestBuildLineRegex(it->c_str())); \
     }
   cmCTestBuildHandlerPopulateRegexVector(
     this->CustomErrorMatches, this->ErrorMatchRegex);
@@ -1059,26 +1209,18 @@ void cmCTestBuildHandler::ProcessBuffer(const char* data, int length,
   t_BuildProcessingQueueType* queue)
 {
   const std::string::size_type tick_line_len = 50;
-  const char* ptr;
-  for ( ptr = data; ptr < data+length; ptr ++ )
-    {
-    queue->push_back(*ptr);
-    }
+  const char* ptr = data;
+  const char* end = data + length;
   this->BuildOutputLogSize += length;
 
   // until there are any lines left in the buffer
   while ( 1 )
     {
     // Find the end of line
-    t_BuildProcessingQueueType::iterator it;
-    for ( it = queue->begin();
-      it != queue->end();
-      ++ it )
+    const char* eol = 0;
+    if ( ptr < end )
       {
-      if ( *it == '\n' )
-        {
-        break;
-        }
+      eol = static_cast<const char*>(memchr(ptr, '\n', end - ptr));
       }
 
     // Once certain number of errors or warnings reached, ignore future errors
@@ -1093,24 +1235,18 @@ void cmCTestBuildHandler::ProcessBuffer(const char* data, int length,
       }
 
     // If the end of line was found
-    if ( it != queue->end() )
+    if ( eol )
       {
-      // Create a contiguous array for the line
-      this->CurrentProcessingLine.clear();
-      t_BuildProcessingQueueType::iterator cit;
-      for ( cit = queue->begin(); cit != it; ++cit )
-        {
-        this->CurrentProcessingLine.push_back(*cit);
-        }
-      this->CurrentProcessingLine.push_back(0);
-      const char* line = &*this->CurrentProcessingLine.begin();
+      // Join the line with its start left over from the previous chunk
+      this->CurrentProcessingLine = *queue;
+      this->CurrentProcessingLine.append(ptr, eol);
+      queue->clear();
+      ptr = eol + 1;
+      const char* line = this->CurrentProcessingLine.c_str();
 
       // Process the line
       int lineType = this->ProcessSingleLine(line);
 
-      // Erase the line from the queue
-      queue->erase(queue->begin(), it+1);
-
       // Depending on the line type, produce error or warning, or nothing
       cmCTestBuildErrorWarning errorwarning;
       bool found = false;
@@ -1182,6 +1318,8 @@ void cmCTestBuildHandler::ProcessBuffer(const char* data, int length,
       }
     else
       {
+      // Keep the start of the next line for the next chunk
+      queue->append(ptr, end);
       break;
       }
     }
@@ -1224,7 +1362,7 @@ int cmCTestBuildHandler::ProcessSingleLine(const char* data)
 
   cmCTestLog(this->CTest, DEBUG, "Line: [" << data << "]" << std::endl);
 
-  std::vector<cmsys::RegularExpression>::iterator it;
+  std::vector<cmCTestBuildLineRegex>::iterator it;
 
   int warningLine = 0;
   int errorLine = 0;
@@ -1239,7 +1377,7 @@ int cmCTestBuildHandler::ProcessSingleLine(const char* data)
       it != this->ErrorMatchRegex.end();
       ++ it )
       {
-      if ( it->find(data) )
+      if ( it->Find(data) )
         {
         errorLine = 1;
         cmCTestLog(this->CTest, DEBUG, "  Error Line: " << data
@@ -1255,7 +1393,7 @@ int cmCTestBuildHandler::ProcessSingleLine(const char* data)
       it != this->ErrorExceptionRegex.end();
       ++ it )
       {
-      if ( it->find(data) )
+      if ( it->Find(data) )
         {
         errorLine = 0;
         cmCTestLog(this->CTest, DEBUG, "  Not an error Line: " << data
@@ -1274,7 +1412,7 @@ int cmCTestBuildHandler::ProcessSingleLine(const char* data)
       it != this->WarningMatchRegex.end();
       ++ it )
       {
-      if ( it->find(data) )
+      if ( it->Find(data) )
         {
         warningLine = 1;
         cmCTestLog(this->CTest, DEBUG,
@@ -1292,7 +1430,7 @@ int cmCTestBuildHandler::ProcessSingleLine(const char* data)
       it != this->WarningExceptionRegex.end();
       ++ it )
       {
-      if ( it->find(data) )
+      if ( it->Find(data) )
         {
         warningLine = 0;
         cmCTestLog(this->CTest, DEBUG, "  Not a warning Line: " << data
@@ -71,6 +71,17 @@ private:
     cmsys::RegularExpression RegularExpression;
     };
 
+  // A log scraping regular expression with the longest literal string
+  // every match contains, checked first as a cheap filter.
+  class cmCTestBuildLineRegex
+    {
+  public:
+    cmCTestBuildLineRegex(const char* regex);
+    bool Find(const char* line);
+    cmsys::RegularExpression RegularExpression;
+    std::string RequiredLiteral;
+    };
+
   struct cmCTestBuildErrorWarning
   {
     bool        Error;
@@ -105,12 +116,13 @@ private:
   std::vector<std::string> ReallyCustomWarningExceptions;
   std::vector<cmCTestCompileErrorWarningRex> ErrorWarningFileLineRegex;
 
-  std::vector<cmsys::RegularExpression> ErrorMatchRegex;
-  std::vector<cmsys::RegularExpression> ErrorExceptionRegex;
-  std::vector<cmsys::RegularExpression> WarningMatchRegex;
-  std::vector<cmsys::RegularExpression> WarningExceptionRegex;
+  std::vector<cmCTestBuildLineRegex> ErrorMatchRegex;
+  std::vector<cmCTestBuildLineRegex> ErrorExceptionRegex;
+  std::vector<cmCTestBuildLineRegex> WarningMatchRegex;
+  std::vector<cmCTestBuildLineRegex> WarningExceptionRegex;
 
-  typedef std::deque<char> t_BuildProcessingQueueType;
+  // Holds the start of a line until the rest of it is read.
+  typedef std::string t_BuildProcessingQueueType;
 
   void ProcessBuffer(const char* data, int length, size_t& tick,
     size_t tick_len, std::ostream& ofs, t_BuildProcessingQueueType* queue);
@@ -119,7 +131,7 @@ private:
   t_BuildProcessingQueueType            BuildProcessingQueue;
   t_BuildProcessingQueueType            BuildProcessingErrorQueue;
   size_t                                BuildOutputLogSize;
-  std::vector<char>                     CurrentProcessingLine;
+  std::string                           CurrentProcessingLine;
 
   std::string                           SimplifySourceDir;
   std::string                           SimplifyBuildDir;
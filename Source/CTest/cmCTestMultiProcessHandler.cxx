@@ -19,6 +19,12 @@
 #include <float.h>
 #include <cmsys/FStream.hxx>
 
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
 class TestComparator
 {
 public:
@@ -43,6 +49,8 @@ cmCTestMultiProcessHandler::cmCTestMultiProcessHandler()
   this->RunningCount = 0;
   this->StopTimePassed = false;
   this->HasCycles = false;
+  this->IdleTimeout = 0.001;
+  this->PredictedTime = 0;
 }
 
 cmCTestMultiProcessHandler::~cmCTestMultiProcessHandler()
@@ -82,6 +90,28 @@ void cmCTestMultiProcessHandler::SetParallelLevel(size_t level)
   this->ParallelLevel = level < 1 ? 1 : level;
 }
 
+//---------------------------------------------------------
+// The processor time used by this process in seconds.
+static double cmCTestMultiProcessHandlerProcessorTime()
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if(!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime,
+                      &kernelTime, &userTime))
+    {
+    return 0;
+    }
+  ULARGE_INTEGER k, u;
+  k.LowPart = kernelTime.dwLowDateTime;
+  k.HighPart = kernelTime.dwHighDateTime;
+  u.LowPart = userTime.dwLowDateTime;
+  u.HighPart = userTime.dwHighDateTime;
+  return static_cast<double>(k.QuadPart + u.QuadPart) / 1e7;
+#else
+  return static_cast<double>(clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
 //---------------------------------------------------------
 void cmCTestMultiProcessHandler::RunTests()
 {
@@ -91,6 +121,8 @@ void cmCTestMultiProcessHandler::RunTests()
     return;
     }
   this->TestHandler->SetMaxIndex(this->FindMaxIndex());
+  double clockStart = cmSystemTools::GetTime();
+  double cpuStart = cmCTestMultiProcessHandlerProcessorTime();
   this->StartNextTests();
   while(this->Tests.size() != 0)
     {
@@ -105,6 +137,21 @@ void cmCTestMultiProcessHandler::RunTests()
   while(this->CheckOutput())
     {
     }
+  char buf[64];
+  sprintf(buf, "%6.2f sec",
+          cmCTestMultiProcessHandlerProcessorTime() - cpuStart);
+  cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+             "ctest processor time while running tests = "
+             << buf << std::endl);
+  if(this->PredictedTime > 0)
+    {
+    sprintf(buf, "%6.2f sec", this->PredictedTime);
+    cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+               "Predicted test time from cost data = " << buf << std::endl);
+    sprintf(buf, "%6.2f sec", cmSystemTools::GetTime() - clockStart);
+    cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+               "Actual test time = " << buf << std::endl);
+    }
   this->MarkFinished();
   this->UpdateCostData();
 }
@@ -273,15 +320,48 @@ bool cmCTestMultiProcessHandler::CheckOutput()
     return false;
     }
   std::vector<cmCTestRunTest*> finished;
-  std::string out, err;
+  bool activity = false;
   for(std::set<cmCTestRunTest*>::const_iterator i = this->RunningTests.begin();
       i != this->RunningTests.end(); ++i)
     {
     cmCTestRunTest* p = *i;
-    if(!p->CheckOutput())
+    if(!p->CheckOutput(0, activity))
+      {
+      finished.push_back(p);
+      }
+    }
+  if(finished.empty() && !activity)
+    {
+    // Nothing happened.  Wait on one test, which returns as soon as it
+    // produces output or exits.  The others are checked again after a
+    // delay that grows while all tests stay quiet, so neither a busy
+    // loop nor a long wait on a single test delays starting the next.
+    cmCTestRunTest* p = *this->RunningTests.begin();
+    double timeout = this->IdleTimeout;
+    if(this->RunningTests.size() == 1)
+      {
+      timeout = 0.1;
+      }
+    if(!p->CheckOutput(timeout, activity))
       {
       finished.push_back(p);
       }
+    if(finished.empty() && !activity)
+      {
+      this->IdleTimeout *= 2;
+      if(this->IdleTimeout > 0.05)
+        {
+        this->IdleTimeout = 0.05;
+        }
+      }
+    else
+      {
+      this->IdleTimeout = 0.001;
+      }
+    }
+  else
+    {
+    this->IdleTimeout = 0.001;
     }
   for( std::vector<cmCTestRunTest*>::iterator i = finished.begin();
        i != finished.end(); ++i)
@@ -460,13 +540,94 @@ void cmCTestMultiProcessHandler::CreateTestCostList()
 }
 
 //---------------------------------------------------------
-void cmCTestMultiProcessHandler::CreateParallelTestCostList()
+namespace
 {
-  TestSet alreadySortedTests;
+// Scheduling priority of a test in a parallel run.
+struct TestCriticalPath
+{
+  // Cost of the test plus that of the longest chain of tests that
+  // depend on it
+  float Cost;
+  // Number of tests on that chain, including the test itself
+  int Depth;
+  // Largest total cost of a group of tests sharing a resource lock
+  // with the test
+  float Locked;
+};
+typedef std::map<int, TestCriticalPath> TestCriticalPathMap;
+
+class TestCriticalPathComparator
+{
+public:
+  TestCriticalPathComparator(TestCriticalPathMap const& paths):
+    Paths(paths) {}
+
+  // Sorts tests in descending order of their critical path
+  bool operator() (int index1, int index2) const
+    {
+    TestCriticalPath const& p1 = this->Paths.find(index1)->second;
+    TestCriticalPath const& p2 = this->Paths.find(index2)->second;
+    if(p1.Cost != p2.Cost)
+      {
+      return p1.Cost > p2.Cost;
+      }
+    if(p1.Locked != p2.Locked)
+      {
+      return p1.Locked > p2.Locked;
+      }
+    return p1.Depth > p2.Depth;
+    }
+
+private:
+  TestCriticalPathMap const& Paths;
+};
+}
 
-  std::list<TestSet> priorityStack;
-  priorityStack.push_back(TestSet());
-  TestSet &topLevel = priorityStack.back();
+//---------------------------------------------------------
+static TestCriticalPath const&
+cmCTestMultiProcessHandlerCriticalPath(
+  int test, cmCTestMultiProcessHandler::TestMap& dependents,
+  cmCTestMultiProcessHandler::PropertiesMap& properties,
+  TestCriticalPathMap& paths)
+{
+  TestCriticalPathMap::iterator found = paths.find(test);
+  if(found != paths.end())
+    {
+    return found->second;
+    }
+
+  TestCriticalPath path;
+  path.Cost = 0;
+  path.Depth = 0;
+  path.Locked = 0;
+  bool first = true;
+  cmCTestMultiProcessHandler::TestSet const& testDependents =
+    dependents[test];
+  for(cmCTestMultiProcessHandler::TestSet::const_iterator i =
+        testDependents.begin(); i != testDependents.end(); ++i)
+    {
+    TestCriticalPath const& next =
+      cmCTestMultiProcessHandlerCriticalPath(*i, dependents,
+                                             properties, paths);
+    if(first || next.Cost > path.Cost)
+      {
+      path.Cost = next.Cost;
+      }
+    if(next.Depth > path.Depth)
+      {
+      path.Depth = next.Depth;
+      }
+    first = false;
+    }
+  path.Cost += properties[test]->Cost;
+  path.Depth += 1;
+  return paths[test] = path;
+}
+
+//---------------------------------------------------------
+void cmCTestMultiProcessHandler::CreateParallelTestCostList()
+{
+  TestList presortedList;
 
   // In parallel test runs add previously failed tests to the front
   // of the cost list and queue other tests for further sorting
@@ -478,71 +639,91 @@ void cmCTestMultiProcessHandler::CreateParallelTestCostList()
       {
       //If the test failed last time, it should be run first.
       this->SortedTests.push_back(i->first);
-      alreadySortedTests.insert(i->first);
       }
     else
       {
-      topLevel.insert(i->first);
+      presortedList.push_back(i->first);
       }
     }
 
-  // In parallel test runs repeatedly move dependencies of the tests on
-  // the current dependency level to the next level until no
-  // further dependencies exist.
-  while(priorityStack.back().size())
+  // Invert the dependency graph and total the cost of the tests
+  // holding each resource lock.
+  TestMap dependents;
+  std::map<std::string, float> lockedCost;
+  float totalCost = 0;
+  for(TestMap::const_iterator i = this->Tests.begin();
+    i != this->Tests.end(); ++i)
     {
-    TestSet &previousSet = priorityStack.back();
-    priorityStack.push_back(TestSet());
-    TestSet &currentSet = priorityStack.back();
+    cmCTestTestHandler::cmCTestTestProperties* p =
+      this->Properties[i->first];
+    for(TestSet::const_iterator j = i->second.begin();
+      j != i->second.end(); ++j)
+      {
+      dependents[*j].insert(i->first);
+      }
+    float cost = p->Cost > 0 ? p->Cost : 0;
+    for(std::set<std::string>::const_iterator j =
+          p->LockedResources.begin(); j != p->LockedResources.end(); ++j)
+      {
+      lockedCost[*j] += cost;
+      }
+    totalCost += cost * static_cast<float>(this->GetProcessorsUsed(i->first));
+    }
 
-    for(TestSet::const_iterator i = previousSet.begin();
-      i != previousSet.end(); ++i)
+  // Give each test the cost of the longest chain of tests that
+  // cannot start before it finishes.  Starting the tests on the
+  // longest chains first keeps them from dominating the total time.
+  TestCriticalPathMap paths;
+  float longestPath = 0;
+  float longestLocked = 0;
+  for(TestMap::const_iterator i = this->Tests.begin();
+    i != this->Tests.end(); ++i)
+    {
+    cmCTestMultiProcessHandlerCriticalPath(i->first, dependents,
+                                           this->Properties, paths);
+    TestCriticalPath& path = paths[i->first];
+    std::set<std::string> const& locks =
+      this->Properties[i->first]->LockedResources;
+    for(std::set<std::string>::const_iterator j = locks.begin();
+      j != locks.end(); ++j)
       {
-      TestSet const& dependencies = this->Tests[*i];
-      for(TestSet::const_iterator j = dependencies.begin();
-        j != dependencies.end(); ++j)
+      if(lockedCost[*j] > path.Locked)
         {
-        currentSet.insert(*j);
+        path.Locked = lockedCost[*j];
         }
       }
-
-    for(TestSet::const_iterator i = currentSet.begin();
-      i != currentSet.end(); ++i)
+    if(path.Cost > longestPath)
+      {
+      longestPath = path.Cost;
+      }
+    if(path.Locked > longestLocked)
       {
-      previousSet.erase(*i);
+      longestLocked = path.Locked;
       }
     }
 
-  // Remove the empty dependency level
-  priorityStack.pop_back();
-
-  // Reverse iterate over the different dependency levels (deepest first).
-  // Sort tests within each level by COST and append them to the cost list.
-  for(std::list<TestSet>::reverse_iterator i = priorityStack.rbegin();
-    i != priorityStack.rend(); ++i)
+  // The run cannot take less than its longest chain, its longest
+  // group of serialized tests or its total cost spread over all slots.
+  this->PredictedTime = totalCost / static_cast<float>(this->ParallelLevel);
+  if(longestPath > this->PredictedTime)
     {
-    TestSet const& currentSet = *i;
-    TestComparator comp(this);
-
-    TestList sortedCopy;
-
-    for(TestSet::const_iterator j = currentSet.begin();
-      j != currentSet.end(); ++j)
-      {
-      sortedCopy.push_back(*j);
-      }
+    this->PredictedTime = longestPath;
+    }
+  if(longestLocked > this->PredictedTime)
+    {
+    this->PredictedTime = longestLocked;
+    }
 
-    std::stable_sort(sortedCopy.begin(), sortedCopy.end(), comp);
+  // Sort by own cost first so that ties keep the cheaper tests last.
+  std::stable_sort(presortedList.begin(), presortedList.end(),
+                   TestComparator(this));
+  std::stable_sort(presortedList.begin(), presortedList.end(),
+                   TestCriticalPathComparator(paths));
 
-    for(TestList::const_iterator j = sortedCopy.begin();
-      j != sortedCopy.end(); ++j)
-      {
-      if(alreadySortedTests.find(*j) == alreadySortedTests.end())
-        {
-        this->SortedTests.push_back(*j);
-        alreadySortedTests.insert(*j);
-        }
-      }
+  for(TestList::const_iterator i = presortedList.begin();
+    i != presortedList.end(); ++i)
+    {
+    this->SortedTests.push_back(*i);
     }
 }
 
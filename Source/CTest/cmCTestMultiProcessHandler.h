@@ -118,6 +118,10 @@ protected:
   cmCTestTestHandler * TestHandler;
   cmCTest* CTest;
   bool HasCycles;
+  // How long to wait for a test when none shows activity
+  double IdleTimeout;
+  // Lower bound on the time to run all tests computed from cost data
+  float PredictedTime;
 };
 
 #endif
@@ -30,6 +30,9 @@ cmCTestRunTest::cmCTestRunTest(cmCTestTestHandler* handler)
   this->TestResult.TestCount = 0;
   this->TestResult.Properties = 0;
   this->ProcessOutput = "";
+  this->ProcessOutputHeadSize = 0;
+  this->ProcessOutputTailSize = 0;
+  this->ProcessOutputDropped = 0;
   this->CompressedOutput = "";
   this->CompressionRatio = 2;
   this->StopTimePassed = false;
@@ -40,13 +43,14 @@ cmCTestRunTest::~cmCTestRunTest()
 }
 
 //----------------------------------------------------------------------------
-bool cmCTestRunTest::CheckOutput()
+bool cmCTestRunTest::CheckOutput(double timeout, bool& activity)
 {
-  // Read lines for up to 0.1 seconds of total time.
-  double timeout = 0.1;
-  double timeEnd = cmSystemTools::GetTime() + timeout;
+  // Wait for the first line, then read the lines already available for
+  // up to 0.1 seconds so a test with a lot of output cannot stall the
+  // others.
+  double timeEnd = cmSystemTools::GetTime() + timeout + 0.1;
   std::string line;
-  while((timeout = timeEnd - cmSystemTools::GetTime(), timeout > 0))
+  for(;;)
     {
     int p = this->TestProcess->GetNextOutputLine(line, timeout);
     if(p == cmsysProcess_Pipe_None)
@@ -60,8 +64,13 @@ bool cmCTestRunTest::CheckOutput()
       // Store this line of output.
       cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
                  this->GetIndex() << ": " << line << std::endl);
-      this->ProcessOutput += line;
-      this->ProcessOutput += "\n";
+      this->AppendOutput(line);
+      activity = true;
+      timeout = 0;
+      if(cmSystemTools::GetTime() > timeEnd)
+        {
+        break;
+        }
       }
     else // if(p == cmsysProcess_Pipe_Timeout)
       {
@@ -71,6 +80,187 @@ bool cmCTestRunTest::CheckOutput()
   return true;
 }
 
+//----------------------------------------------------------------------------
+// Number of lines matched again with the next piece of output once the
+// output is cut into pieces, so patterns spanning lines still match.
+static const int cmCTestRunTestOverlapLines = 10;
+
+//----------------------------------------------------------------------------
+static std::string cmCTestRunTestLastLines(std::string const& output,
+                                           int lines)
+{
+  std::string::size_type pos = output.size();
+  // The output ends in a newline which does not start another line.
+  if(pos > 0)
+    {
+    --pos;
+    }
+  for(int i = 0; i < lines; ++i)
+    {
+    if(pos == 0)
+      {
+      return output;
+      }
+    pos = output.rfind('\n', pos - 1);
+    if(pos == std::string::npos)
+      {
+      return output;
+      }
+    }
+  return output.substr(pos + 1);
+}
+
+//----------------------------------------------------------------------------
+// Whether a regular expression uses "^" or "$", which match only at the
+// start and end of the whole output and so cannot be matched piecewise.
+static bool cmCTestRunTestIsAnchored(std::string const& regex)
+{
+  for(const char* p = regex.c_str(); *p; ++p)
+    {
+    if(*p == '\\')
+      {
+      if(!*++p)
+        {
+        break;
+        }
+      }
+    else if(*p == '[')
+      {
+      // Skip the bracket expression, where "^" is a complement.
+      ++p;
+      if(*p == '^')
+        {
+        ++p;
+        }
+      if(*p == ']')
+        {
+        ++p;
+        }
+      while(*p && *p != ']')
+        {
+        ++p;
+        }
+      if(!*p)
+        {
+        break;
+        }
+      }
+    else if(*p == '^' || *p == '$')
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void cmCTestRunTest::AppendOutput(std::string const& line)
+{
+  if(!this->ProcessOutputHeadSize ||
+     this->ProcessOutput.size() < this->ProcessOutputHeadSize)
+    {
+    this->ProcessOutput += line;
+    this->ProcessOutput += "\n";
+    return;
+    }
+
+  // The head is full.  Keep the most recent output in the tail and drop
+  // whole lines from its front once it holds twice the tail size.
+  std::string& tail = this->ProcessOutputTail;
+  tail += line;
+  tail += "\n";
+  if(tail.size() <= 2 * this->ProcessOutputTailSize)
+    {
+    return;
+    }
+  std::string::size_type cut =
+    tail.find('\n', tail.size() - this->ProcessOutputTailSize) + 1;
+  std::string dropped = tail.substr(0, cut);
+
+  // Tests asking for their full output get it if they say so before
+  // anything is dropped.
+  if(!this->ProcessOutputDropped &&
+     (this->ProcessOutput.find("CTEST_FULL_OUTPUT") != std::string::npos ||
+      dropped.find("CTEST_FULL_OUTPUT") != std::string::npos))
+    {
+    this->ProcessOutput += tail;
+    tail = "";
+    this->ProcessOutputHeadSize = 0;
+    return;
+    }
+
+  // Match the dropped lines together with the lines before them.
+  if(!this->ProcessOutputDropped)
+    {
+    this->ProcessOutputOverlap =
+      cmCTestRunTestLastLines(this->ProcessOutput,
+                              cmCTestRunTestOverlapLines);
+    }
+  std::string text = this->ProcessOutputOverlap;
+  text += dropped;
+  this->MatchOutput(text.c_str());
+  this->ProcessOutputOverlap =
+    cmCTestRunTestLastLines(text, cmCTestRunTestOverlapLines);
+  tail.erase(0, cut);
+  this->ProcessOutputDropped += cut;
+}
+
+//----------------------------------------------------------------------------
+void cmCTestRunTest::MatchOutput(const char* output)
+{
+  std::vector<std::pair<cmsys::RegularExpression,
+    std::string> >& required =
+    this->TestProperties->RequiredRegularExpressions;
+  for(size_t i = 0; i < required.size(); ++i)
+    {
+    if(!this->RequiredRegularExpressionsFound[i] &&
+       required[i].first.find(output))
+      {
+      this->RequiredRegularExpressionsFound[i] = true;
+      }
+    }
+  std::vector<std::pair<cmsys::RegularExpression,
+    std::string> >& errors =
+    this->TestProperties->ErrorRegularExpressions;
+  for(size_t i = 0; i < errors.size(); ++i)
+    {
+    if(!this->ErrorRegularExpressionsFound[i] &&
+       errors[i].first.find(output))
+      {
+      this->ErrorRegularExpressionsFound[i] = true;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmCTestRunTest::FinishOutput()
+{
+  if(!this->ProcessOutputDropped)
+    {
+    this->ProcessOutput += this->ProcessOutputTail;
+    this->MatchOutput(this->ProcessOutput.c_str());
+    }
+  else
+    {
+    // Match the head and the tail separately so that the note about the
+    // dropped output cannot match.
+    this->MatchOutput(this->ProcessOutput.c_str());
+    std::string text = this->ProcessOutputOverlap;
+    text += this->ProcessOutputTail;
+    this->MatchOutput(text.c_str());
+    cmOStringStream msg;
+    msg << "...\n"
+      "The middle " << this->ProcessOutputDropped << " bytes of the test "
+      "output were dropped since the output exceeds the captured size of "
+      << this->TestHandler->CustomMaximumCapturedTestOutputSize
+      << " bytes.\n...\n";
+    this->ProcessOutput += msg.str();
+    this->ProcessOutput += this->ProcessOutputTail;
+    }
+  std::string().swap(this->ProcessOutputTail);
+  std::string().swap(this->ProcessOutputOverlap);
+}
+
 //---------------------------------------------------------
 // Streamed compression of test output.  The compressed data
 // is appended to this->CompressedOutput
@@ -137,6 +327,8 @@ void cmCTestRunTest::CompressOutput()
 //---------------------------------------------------------
 bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
 {
+  this->FinishOutput();
+
   if ((!this->TestHandler->MemCheck &&
       this->CTest->ShouldCompressTestOutput()) ||
       (this->TestHandler->MemCheck &&
@@ -158,11 +350,10 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
   if ( this->TestProperties->RequiredRegularExpressions.size() > 0 )
     {
     bool found = false;
-    for ( passIt = this->TestProperties->RequiredRegularExpressions.begin();
-          passIt != this->TestProperties->RequiredRegularExpressions.end();
-          ++ passIt )
+    for ( size_t i = 0; i < this->RequiredRegularExpressionsFound.size();
+          ++i )
       {
-      if ( passIt->first.find(this->ProcessOutput.c_str()) )
+      if ( this->RequiredRegularExpressionsFound[i] )
         {
         found = true;
         reason = "Required regular expression found.";
@@ -186,15 +377,13 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
     }
   if ( this->TestProperties->ErrorRegularExpressions.size() > 0 )
     {
-    for ( passIt = this->TestProperties->ErrorRegularExpressions.begin();
-          passIt != this->TestProperties->ErrorRegularExpressions.end();
-          ++ passIt )
+    for ( size_t i = 0; i < this->ErrorRegularExpressionsFound.size(); ++i )
       {
-      if ( passIt->first.find(this->ProcessOutput.c_str()) )
+      if ( this->ErrorRegularExpressionsFound[i] )
         {
         reason = "Error regular expression found in output.";
         reason += " Regex=[";
-        reason += passIt->second;
+        reason += this->TestProperties->ErrorRegularExpressions[i].second;
         reason += "]";
         forceFail = true;
         break;
@@ -416,6 +605,41 @@ bool cmCTestRunTest::StartTest(size_t total)
   this->TestResult.Name = this->TestProperties->Name;
   this->TestResult.Path = this->TestProperties->Directory.c_str();
 
+  // Bound the output kept in memory unless MemCheck needs all of it or
+  // a regular expression must see it as a whole.  The head always covers
+  // what CleanTestOutput keeps for the submission.
+  int captured = this->TestHandler->CustomMaximumCapturedTestOutputSize;
+  this->ProcessOutputHeadSize = 0;
+  this->ProcessOutputTailSize = 0;
+  this->ProcessOutputDropped = 0;
+  bool anchored = false;
+  std::vector<std::pair<cmsys::RegularExpression,
+    std::string> >::const_iterator ri;
+  for(ri = this->TestProperties->RequiredRegularExpressions.begin();
+      ri != this->TestProperties->RequiredRegularExpressions.end(); ++ri)
+    {
+    anchored = anchored || cmCTestRunTestIsAnchored(ri->second);
+    }
+  for(ri = this->TestProperties->ErrorRegularExpressions.begin();
+      ri != this->TestProperties->ErrorRegularExpressions.end(); ++ri)
+    {
+    anchored = anchored || cmCTestRunTestIsAnchored(ri->second);
+    }
+  if(!this->TestHandler->MemCheck && !anchored && captured > 0)
+    {
+    // A tail size of zero would never drop anything.
+    this->ProcessOutputTailSize =
+      static_cast<size_t>(std::max(captured / 2, 1));
+    int head = std::max(captured - captured / 2, std::max(
+      this->TestHandler->CustomMaximumPassedTestOutputSize,
+      this->TestHandler->CustomMaximumFailedTestOutputSize));
+    this->ProcessOutputHeadSize = static_cast<size_t>(head);
+    }
+  this->RequiredRegularExpressionsFound.assign(
+    this->TestProperties->RequiredRegularExpressions.size(), false);
+  this->ErrorRegularExpressionsFound.assign(
+    this->TestProperties->ErrorRegularExpressions.size(), false);
+
   if(args.size() >= 2 && args[1] == "NOT_AVAILABLE")
     {
     this->TestProcess = new cmProcess;
@@ -44,8 +44,10 @@ public:
   cmCTestTestHandler::cmCTestTestResult GetTestResults()
   { return this->TestResult; }
 
-  // Read and store output.  Returns true if it must be called again.
-  bool CheckOutput();
+  // Read and store output, waiting up to the given time for it.  Sets
+  // activity if any output was read.  Returns true if it must be called
+  // again, or false once the process has exited.
+  bool CheckOutput(double timeout, bool& activity);
 
   // Compresses the output, writing to CompressedOutput
   void CompressOutput();
@@ -59,6 +61,15 @@ public:
 
   void ComputeWeightedCost();
 private:
+  // Store a line of output, keeping at most a head and a tail of it once
+  // the output grows beyond the captured output size.
+  void AppendOutput(std::string const& line);
+  // Match the regular expressions not found so far against output that
+  // is about to be dropped.
+  void MatchOutput(const char* output);
+  // Match the remaining regular expressions and join the head and tail
+  // of the output.
+  void FinishOutput();
   void DartProcessing();
   void ExeNotFound(std::string exe);
   // Figures out a final timeout which is min(STOP_TIME, NOW+TIMEOUT)
@@ -83,6 +94,15 @@ private:
   std::string PrefixCommand;
 
   std::string ProcessOutput;
+  //Output after the head while the captured output size is exceeded
+  std::string ProcessOutputTail;
+  size_t ProcessOutputHeadSize;
+  size_t ProcessOutputTailSize;
+  size_t ProcessOutputDropped;
+  //Last lines matched so far, matched again with the next piece
+  std::string ProcessOutputOverlap;
+  std::vector<bool> RequiredRegularExpressionsFound;
+  std::vector<bool> ErrorRegularExpressionsFound;
   std::string CompressedOutput;
   double CompressionRatio;
   //The test results
@@ -391,6 +391,7 @@ cmCTestTestHandler::cmCTestTestHandler()
 
   this->CustomMaximumPassedTestOutputSize = 1 * 1024;
   this->CustomMaximumFailedTestOutputSize = 300 * 1024;
+  this->CustomMaximumCapturedTestOutputSize = 8 * 1024 * 1024;
 
   this->MemCheck = false;
 
@@ -421,6 +422,7 @@ void cmCTestTestHandler::Initialize()
   this->CustomPostTest.clear();
   this->CustomMaximumPassedTestOutputSize = 1 * 1024;
   this->CustomMaximumFailedTestOutputSize = 300 * 1024;
+  this->CustomMaximumCapturedTestOutputSize = 8 * 1024 * 1024;
 
   this->TestsToRun.clear();
 
@@ -455,6 +457,9 @@ void cmCTestTestHandler::PopulateCustomVectors(cmMakefile *mf)
   this->CTest->PopulateCustomInteger(mf,
                              "CTEST_CUSTOM_MAXIMUM_FAILED_TEST_OUTPUT_SIZE",
                              this->CustomMaximumFailedTestOutputSize);
+  this->CTest->PopulateCustomInteger(mf,
+                             "CTEST_CUSTOM_MAXIMUM_CAPTURED_TEST_OUTPUT_SIZE",
+                             this->CustomMaximumCapturedTestOutputSize);
 }
 
 //----------------------------------------------------------------------
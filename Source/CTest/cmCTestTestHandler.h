@@ -185,6 +185,7 @@ protected:
   bool MemCheck;
   int CustomMaximumPassedTestOutputSize;
   int CustomMaximumFailedTestOutputSize;
+  int CustomMaximumCapturedTestOutputSize;
   int MaxIndex;
 public:
   enum { // Program statuses
@@ -43,6 +43,11 @@ public:
    */
   virtual std::string GetName() const {return "add_definitions";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmAddDefinitionsCommand, cmCommand);
 };
 
@@ -47,6 +47,11 @@ public:
    */
   virtual std::string GetName() const {return "break";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmBreakCommand, cmCommand);
 };
 
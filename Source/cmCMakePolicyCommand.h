@@ -48,6 +48,11 @@ public:
    */
   virtual std::string GetName() const {return "cmake_policy";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmCMakePolicyCommand, cmCommand);
 private:
   bool HandleSetMode(std::vector<std::string> const& args);
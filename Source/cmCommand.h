@@ -93,6 +93,17 @@ public:
    */
   virtual cmCommand* Clone() = 0;
 
+  /**
+   * Does this command keep no state in its members between
+   * invocations?  Such a command is invoked directly on its registered
+   * prototype instead of on a fresh clone.  It must not have a final
+   * pass.
+   */
+  virtual bool IsStateless() const
+    {
+    return false;
+    }
+
   /**
    * This determines if the command is invoked when in script mode.
    */
@@ -163,6 +174,14 @@ public:
       return this->Error.c_str();
     }
 
+  /**
+   * Clear the error message of a previous invocation.
+   */
+  void ClearError()
+    {
+    this->Error = "";
+    }
+
   /**
    * Set the error message
    */
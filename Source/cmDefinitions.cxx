@@ -15,91 +15,176 @@
 cmDefinitions::Def cmDefinitions::NoDef;
 
 //----------------------------------------------------------------------------
-cmDefinitions::cmDefinitions(cmDefinitions* parent)
-  : Up(parent)
+cmDefinitions::cmDefinitions()
 {
 }
 
 //----------------------------------------------------------------------------
-void cmDefinitions::Reset(cmDefinitions* parent)
+void cmDefinitions::PushScope()
 {
-  this->Up = parent;
-  this->Map.clear();
+  this->Scopes.push_back(std::vector<std::string>());
 }
 
 //----------------------------------------------------------------------------
-cmDefinitions::Def const&
-cmDefinitions::GetInternal(const std::string& key) const
+void cmDefinitions::PopScope()
 {
-  MapType::const_iterator i = this->Map.find(key);
-  if(i != this->Map.end())
+  if(this->Scopes.empty())
     {
-    return i->second;
+    return;
     }
-  if(cmDefinitions* up = this->Up)
+  std::vector<std::string> const& keys = this->Scopes.back();
+  for(std::vector<std::string>::const_iterator ki = keys.begin();
+      ki != keys.end(); ++ki)
     {
-    // Query the parent scope.
-    return up->GetInternal(key);
+    MapType::iterator i = this->Map.find(*ki);
+    if(i == this->Map.end())
+      {
+      continue;
+      }
+    // Bindings of inner scopes are gone so ours is the innermost.
+    i->second.pop_back();
+    if(i->second.empty())
+      {
+      this->Map.erase(i);
+      }
     }
-  return this->NoDef;
+  this->Scopes.pop_back();
 }
 
 //----------------------------------------------------------------------------
-cmDefinitions::Def const&
-cmDefinitions::SetInternal(const std::string& key, Def const& def)
+const char* cmDefinitions::Get(const std::string& key) const
 {
-  if(this->Up || def.Exists)
-    {
-    // In lower scopes we store keys, defined or not.
-    return (this->Map[key] = def);
-    }
-  else
+  MapType::const_iterator i = this->Map.find(key);
+  if(i == this->Map.end())
     {
-    // In the top-most scope we need not store undefined keys.
-    this->Map.erase(key);
-    return this->NoDef;
+    return 0;
     }
+  Def const& def = i->second.back().Value;
+  return def.Exists? def.c_str() : 0;
 }
 
 //----------------------------------------------------------------------------
-const char* cmDefinitions::Get(const std::string& key) const
+void cmDefinitions::Bind(BindingStack& bindings, const std::string& key,
+                         size_t depth, Def const& def)
 {
-  Def const& def = this->GetInternal(key);
-  return def.Exists? def.c_str() : 0;
+  // Find the first binding of a scope at or below the given depth.
+  BindingStack::iterator pos = bindings.end();
+  while(pos != bindings.begin())
+    {
+    BindingStack::iterator prev = pos;
+    --prev;
+    if(prev->Depth < depth)
+      {
+      break;
+      }
+    pos = prev;
+    }
+
+  if(pos != bindings.end() && pos->Depth == depth)
+    {
+    if(depth == 0 && !def.Exists)
+      {
+      // In the top-most scope we need not store undefined keys.
+      bindings.erase(pos);
+      }
+    else
+      {
+      pos->Value.assign(def);
+      pos->Value.Exists = def.Exists;
+      }
+    }
+  else if(depth > 0 || def.Exists)
+    {
+    // In lower scopes we store keys, defined or not.
+    bindings.insert(pos, Binding(depth, def));
+    if(depth > 0)
+      {
+      this->Scopes[depth-1].push_back(key);
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
-void cmDefinitions::Pull(const std::string& key)
+const char* cmDefinitions::Set(const std::string& key, const char* value)
 {
-  if (this->Up)
+  Def def(value);
+  MapType::iterator i = this->Map.find(key);
+  if(i == this->Map.end())
     {
-    Def const& def = this->Up->GetInternal(key);
-    if (def.Exists)
+    if(!def.Exists && this->Scopes.empty())
       {
-      this->SetInternal(key, def);
+      return 0;
       }
+    i = this->Map.insert(MapType::value_type(key, BindingStack())).first;
     }
+  this->Bind(i->second, key, this->Scopes.size(), def);
+  if(i->second.empty())
+    {
+    this->Map.erase(i);
+    return 0;
+    }
+  Def const& cur = i->second.back().Value;
+  return cur.Exists? cur.c_str() : 0;
 }
 
 //----------------------------------------------------------------------------
-const char* cmDefinitions::Set(const std::string& key, const char* value)
+void cmDefinitions::RaiseScope(const std::string& key, const char* value)
 {
-  Def const& def = this->SetInternal(key, Def(value));
-  return def.Exists? def.c_str() : 0;
+  size_t depth = this->Scopes.size();
+  if(depth == 0)
+    {
+    return;
+    }
+  MapType::iterator i =
+    this->Map.insert(MapType::value_type(key, BindingStack())).first;
+  BindingStack& bindings = i->second;
+
+  // First localize the definition in the current scope.  The value the
+  // parent scope sees replaces any local binding.
+  for(BindingStack::reverse_iterator ri = bindings.rbegin();
+      ri != bindings.rend(); ++ri)
+    {
+    if(ri->Depth < depth)
+      {
+      if(ri->Value.Exists)
+        {
+        Def parent = ri->Value;
+        this->Bind(bindings, key, depth, parent);
+        }
+      break;
+      }
+    }
+
+  // Now update the definition in the parent scope.
+  this->Bind(bindings, key, depth-1, Def(value));
+  if(bindings.empty())
+    {
+    this->Map.erase(i);
+    }
 }
 
 //----------------------------------------------------------------------------
 std::set<std::string> cmDefinitions::LocalKeys() const
 {
   std::set<std::string> keys;
-  // Consider local definitions.
-  for(MapType::const_iterator mi = this->Map.begin();
-      mi != this->Map.end(); ++mi)
+  if(this->Scopes.empty())
     {
-    if (mi->second.Exists)
+    // Every binding left belongs to the top-most scope.
+    for(MapType::const_iterator mi = this->Map.begin();
+        mi != this->Map.end(); ++mi)
       {
       keys.insert(mi->first);
       }
+    return keys;
+    }
+  std::vector<std::string> const& local = this->Scopes.back();
+  for(std::vector<std::string>::const_iterator ki = local.begin();
+      ki != local.end(); ++ki)
+    {
+    if(this->Get(*ki))
+      {
+      keys.insert(*ki);
+      }
     }
   return keys;
 }
@@ -107,76 +192,30 @@ std::set<std::string> cmDefinitions::LocalKeys() const
 //----------------------------------------------------------------------------
 cmDefinitions cmDefinitions::Closure() const
 {
-  return cmDefinitions(ClosureTag(), this);
-}
-
-//----------------------------------------------------------------------------
-cmDefinitions::cmDefinitions(ClosureTag const&, cmDefinitions const* root):
-  Up(0)
-{
-  std::set<std::string> undefined;
-  this->ClosureImpl(undefined, root);
-}
-
-//----------------------------------------------------------------------------
-void cmDefinitions::ClosureImpl(std::set<std::string>& undefined,
-                                cmDefinitions const* defs)
-{
-  // Consider local definitions.
-  for(MapType::const_iterator mi = defs->Map.begin();
-      mi != defs->Map.end(); ++mi)
+  cmDefinitions closure;
+  for(MapType::const_iterator mi = this->Map.begin();
+      mi != this->Map.end(); ++mi)
     {
-    // Use this key if it is not already set or unset.
-    if(this->Map.find(mi->first) == this->Map.end() &&
-       undefined.find(mi->first) == undefined.end())
+    Def const& def = mi->second.back().Value;
+    if(def.Exists)
       {
-      if(mi->second.Exists)
-        {
-        this->Map.insert(*mi);
-        }
-      else
-        {
-        undefined.insert(mi->first);
-        }
+      closure.Map[mi->first].push_back(Binding(0, def));
       }
     }
-
-  // Traverse parents.
-  if(cmDefinitions const* up = defs->Up)
-    {
-    this->ClosureImpl(undefined, up);
-    }
+  return closure;
 }
 
 //----------------------------------------------------------------------------
 std::set<std::string> cmDefinitions::ClosureKeys() const
 {
   std::set<std::string> defined;
-  std::set<std::string> undefined;
-  this->ClosureKeys(defined, undefined);
-  return defined;
-}
-
-//----------------------------------------------------------------------------
-void cmDefinitions::ClosureKeys(std::set<std::string>& defined,
-                                std::set<std::string>& undefined) const
-{
-  // Consider local definitions.
   for(MapType::const_iterator mi = this->Map.begin();
       mi != this->Map.end(); ++mi)
     {
-    // Use this key if it is not already set or unset.
-    if(defined.find(mi->first) == defined.end() &&
-       undefined.find(mi->first) == undefined.end())
+    if(mi->second.back().Value.Exists)
       {
-      std::set<std::string>& m = mi->second.Exists? defined : undefined;
-      m.insert(mi->first);
+      defined.insert(mi->first);
       }
     }
-
-  // Traverse parents.
-  if(cmDefinitions const* up = this->Up)
-    {
-    up->ClosureKeys(defined, undefined);
-    }
+  return defined;
 }
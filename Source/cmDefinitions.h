@@ -18,38 +18,44 @@
 #endif
 
 /** \class cmDefinitions
- * \brief Store a scope of variable definitions for CMake language.
+ * \brief Store the nested scopes of variable definitions for CMake language.
  *
  * This stores the state of variable definitions (set or unset) for
- * one scope.  Sets are always local.  Gets search parent scopes
- * transitively and save results locally.
+ * a stack of scopes.  Sets are always local to the innermost scope.
+ * Each key holds the stack of its own bindings so that a get costs
+ * one lookup regardless of the scope depth, and pushing or popping a
+ * scope costs no more than the number of keys set in it.
  */
 class cmDefinitions
 {
 public:
-  /** Construct with the given parent scope.  */
-  cmDefinitions(cmDefinitions* parent = 0);
+  /** Construct with a single top-most scope.  */
+  cmDefinitions();
 
-  /** Reset object as if newly constructed.  */
-  void Reset(cmDefinitions* parent = 0);
+  /** Enter a new innermost scope.  */
+  void PushScope();
 
-  /** Returns the parent scope, if any.  */
-  cmDefinitions* GetParent() const { return this->Up; }
+  /** Leave the innermost scope and drop its definitions.  */
+  void PopScope();
+
+  /** Returns whether the innermost scope has a parent.  */
+  bool HasParentScope() const { return !this->Scopes.empty(); }
 
   /** Get the value associated with a key; null if none. */
   const char* Get(const std::string& key) const;
 
-  /** Pull a variable from the parent. */
-  void Pull(const std::string& key);
-
   /** Set (or unset if null) a value associated with a key.  */
   const char* Set(const std::string& key, const char* value);
 
-  /** Get the set of all local keys.  */
+  /** Set (or unset if null) a value in the parent scope.  The current
+      value of the key is first localized in the innermost scope.  */
+  void RaiseScope(const std::string& key, const char* value);
+
+  /** Get the set of all keys defined in the innermost scope.  */
   std::set<std::string> LocalKeys() const;
 
   /** Compute the closure of all defined keys with values.
-      This flattens the scope.  The result has no parent.  */
+      This flattens the scopes.  The result has no parent.  */
   cmDefinitions Closure() const;
 
   /** Compute the set of all defined keys.  */
@@ -70,30 +76,31 @@ private:
   };
   static Def NoDef;
 
-  // Parent scope, if any.
-  cmDefinitions* Up;
+  // Definition of a key in the scope at the given depth.
+  struct Binding
+  {
+    Binding(size_t depth, Def const& value): Depth(depth), Value(value) {}
+    size_t Depth;
+    Def Value;
+  };
+
+  // Bindings of a key, innermost last.  A list keeps the values of
+  // outer scopes in place while inner scopes come and go.
+  typedef std::list<Binding> BindingStack;
 
-  // Local definitions, set or unset.
 #if defined(CMAKE_BUILD_WITH_CMAKE)
-  typedef cmsys::hash_map<std::string, Def> MapType;
+  typedef cmsys::hash_map<std::string, BindingStack> MapType;
 #else
-  typedef std::map<std::string, Def> MapType;
+  typedef std::map<std::string, BindingStack> MapType;
 #endif
   MapType Map;
 
-  // Internal query and update methods.
-  Def const& GetInternal(const std::string& key) const;
-  Def const& SetInternal(const std::string& key, Def const& def);
-
-  // Implementation of Closure() method.
-  struct ClosureTag {};
-  cmDefinitions(ClosureTag const&, cmDefinitions const* root);
-  void ClosureImpl(std::set<std::string>& undefined,
-                   cmDefinitions const* defs);
+  // Keys bound in each scope below the top-most one, innermost last.
+  std::vector<std::vector<std::string> > Scopes;
 
-  // Implementation of ClosureKeys() method.
-  void ClosureKeys(std::set<std::string>& defined,
-                   std::set<std::string>& undefined) const;
+  // Internal update method.
+  void Bind(BindingStack& bindings, const std::string& key,
+            size_t depth, Def const& def);
 };
 
 #endif
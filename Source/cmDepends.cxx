@@ -97,15 +97,24 @@ bool cmDepends::Check(const char *makeFile, const char *internalFile,
     cmSystemTools::ChangeDirectory(this->CompileDirectory.c_str());
     }
 
-  // Check whether dependencies must be regenerated.
-  bool okay = true;
+  // Check whether dependencies must be regenerated.  Usually nothing
+  // has changed, so first check without copying the dependencies that
+  // are still valid.  They are needed only if some must be rescanned.
+  bool okay;
+  {
   cmsys::ifstream fin(internalFile);
-  if(!(fin && this->CheckDependencies(fin, internalFile, validDeps)))
+  okay = fin && this->CheckDependencies(fin, internalFile, 0);
+  }
+  if(!okay)
+    {
+    cmsys::ifstream fin(internalFile);
+    okay = fin && this->CheckDependencies(fin, internalFile, &validDeps);
+    }
+  if(!okay)
     {
     // Clear all dependencies so they will be regenerated.
     this->Clear(makeFile);
     cmSystemTools::RemoveFile(internalFile);
-    okay = false;
     }
 
   // Restore working directory.
@@ -147,7 +156,7 @@ bool cmDepends::WriteDependencies(
 //----------------------------------------------------------------------------
 bool cmDepends::CheckDependencies(std::istream& internalDepends,
                                   const char* internalDependsFileName,
-                            std::map<std::string, DependencyVector>& validDeps)
+                            std::map<std::string, DependencyVector>* validDeps)
 {
   // Parse dependencies from the stream.  If any dependee is missing
   // or newer than the depender then dependencies should be
@@ -181,7 +190,10 @@ bool cmDepends::CheckDependencies(std::istream& internalDepends,
       // vector, we lose dependencies for dependers that have multiple
       // entries. No need to initialize the entry, std::map will do so on first
       // access.
-      currentDependencies = &validDeps[this->Depender];
+      if(validDeps)
+        {
+        currentDependencies = &(*validDeps)[this->Depender];
+        }
       continue;
       }
     /*
@@ -205,13 +217,15 @@ bool cmDepends::CheckDependencies(std::istream& internalDepends,
       currentDependencies->push_back(dependee);
       }
 
-    if(!cmSystemTools::FileExists(dependee))
+    // The same dependees appear for many dependers, so check for them
+    // through the file time cache rather than on disk every time.
+    if(!this->FileComparison->FileExists(dependee))
       {
       // The dependee does not exist.
       regenerate = true;
 
       // Print verbose output.
-      if(this->Verbose)
+      if(this->Verbose && validDeps)
         {
         cmOStringStream msg;
         msg << "Dependee \"" << dependee
@@ -233,7 +247,7 @@ bool cmDepends::CheckDependencies(std::istream& internalDepends,
           regenerate = true;
 
           // Print verbose output.
-          if(this->Verbose)
+          if(this->Verbose && validDeps)
             {
             cmOStringStream msg;
             msg << "Dependee \"" << dependee
@@ -255,7 +269,7 @@ bool cmDepends::CheckDependencies(std::istream& internalDepends,
           regenerate = true;
 
           // Print verbose output.
-          if(this->Verbose)
+          if(this->Verbose && validDeps)
             {
             cmOStringStream msg;
             msg << "Dependee \"" << dependee
@@ -268,14 +282,19 @@ bool cmDepends::CheckDependencies(std::istream& internalDepends,
       }
     if(regenerate)
       {
-      // Dependencies must be regenerated.
+      // Dependencies must be regenerated.  When only checking, stop
+      // before any output or change so the full check can follow.
+      if(!validDeps)
+        {
+        return false;
+        }
       okay = false;
 
       // Remove the information of this depender from the map, it needs
       // to be rescanned
       if (currentDependencies != 0)
         {
-        validDeps.erase(this->Depender);
+        validDeps->erase(this->Depender);
         currentDependencies = 0;
         }
 
@@ -83,10 +83,11 @@ protected:
 
   // Check dependencies for the target file in the given stream.
   // Return false if dependencies must be regenerated and true
-  // otherwise.
+  // otherwise.  Without validDeps, stop at the first out-of-date
+  // dependency and leave all files alone.
   virtual bool CheckDependencies(std::istream& internalDepends,
                                  const char* internalDependsFileName,
-                           std::map<std::string, DependencyVector>& validDeps);
+                           std::map<std::string, DependencyVector>* validDeps);
 
   // Finalize the dependency information for the target.
   virtual bool Finalize(std::ostream& makeDepends,
@@ -11,10 +11,11 @@
 ============================================================================*/
 #include "cmDependsC.h"
 
-#include "cmFileTimeComparison.h"
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
 #include "cmSystemTools.h"
+#include "cmake.h"
+#include <cmsys/Directory.hxx>
 #include <cmsys/FStream.hxx>
 
 #include <ctype.h> // isspace
@@ -25,12 +26,575 @@
 
 #define INCLUDE_REGEX_LINE_MARKER "#IncludeRegexLine: "
 #define INCLUDE_REGEX_SCAN_MARKER "#IncludeRegexScan: "
-#define INCLUDE_REGEX_COMPLAIN_MARKER "#IncludeRegexComplain: "
 #define INCLUDE_REGEX_TRANSFORM_MARKER "#IncludeRegexTransform: "
 
+//----------------------------------------------------------------------------
+// The entries of the include scan database for one set of rules.
+class cmDependsCSection
+{
+public:
+  cmDependsCSection(): Count(0), Index(0) {}
+
+  // The entries looked up or scanned by this process, or all entries
+  // of a file read as a whole.
+  cmDependsC::FileCacheType Entries;
+
+  // The number of entries of the section in the file and the offset
+  // of their index in its body.
+  cmIML_INT_uint64_t Count;
+  cmIML_INT_uint64_t Index;
+};
+
+//----------------------------------------------------------------------------
+// The include lines of the files scanned in a build tree, in sections
+// for the rules used to scan them.  A cmake_depends run looks up the
+// files it reaches in the database file one at a time and never writes
+// it.  The entries of the files it scans are saved in a file of its
+// target instead.  The check-build-system step, which runs before any
+// scanning in a build, merges the files of the targets into the
+// database and removes them.  Concurrent runs therefore never write
+// the same file.
+class cmDependsCDatabase
+{
+public:
+  typedef cmDependsC::FileCacheType FileCacheType;
+  typedef std::map<std::string, cmDependsCSection> SectionsType;
+
+  cmDependsCDatabase(): Body(0), Scanned(false) {}
+
+  static cmDependsCDatabase& GetInstance()
+    {
+    static cmDependsCDatabase instance;
+    return instance;
+    }
+
+  cmDependsCSection& GetSection(std::string const& rules)
+    {
+    return this->Sections[rules];
+    }
+
+  /** Open the database of the build tree unless it has been opened
+      already.  The entries scanned are saved for the given target.  */
+  void Load(std::string const& homeOutputDir, std::string const& targetDir);
+
+  /** Read the entry of the given file in a section from the database
+      file.  Returns false if it has none.  */
+  bool Find(cmDependsCSection const& section, std::string const& path,
+            cmDependsC::cmIncludeLines& lines);
+
+  /** Save the entries scanned by this process for its target.  */
+  void Save();
+
+  void SetScanned() { this->Scanned = true; }
+
+  /** Merge the entries saved for the targets into the database.  */
+  static void Merge(std::string const& homeOutputDir);
+
+private:
+  static bool ReadHeader(std::istream& fin, SectionsType& sections,
+                         cmIML_INT_uint64_t& checked);
+  static bool ReadLines(std::istream& fin,
+                        cmDependsC::cmIncludeLines& lines);
+  static bool Read(std::string const& fname, SectionsType& sections,
+                   cmIML_INT_uint64_t& checked);
+  static bool Write(std::string const& fname, SectionsType const& sections,
+                    cmIML_INT_uint64_t checked, bool scannedOnly);
+
+  std::string TargetFile;
+  cmsys::ifstream File;
+  cmIML_INT_uint64_t Body;
+  SectionsType Sections;
+  bool Scanned;
+};
+
+#define INCLUDE_SCAN_DATABASE_MAGIC "#CMakeIncludeScanDatabase: 2"
+#define INCLUDE_SCAN_CHECKED_MARKER "#Checked: "
+#define INCLUDE_SCAN_SECTION_MARKER "#Section: "
+#define INCLUDE_SCAN_INDEX_WIDTH 17
+#define INCLUDE_SCAN_DATABASE_FILE "/IncludeScan.db"
+#define INCLUDE_SCAN_TARGETS_DIR "/IncludeScan.d"
+
+//----------------------------------------------------------------------------
+// The database file and the files of the targets start with a header
+// listing the sections:
+//
+//   #CMakeIncludeScanDatabase: 2
+//   #Checked: <number of entries when all were last checked>
+//   #Section: <number of entries> <offset of the index in the body>
+//   #IncludeRegexLine: ...
+//   #IncludeRegexScan: ...
+//   #IncludeRegexTransform: ...
+//   ...
+//   <empty line>
+//
+// The body starts with the index of each section.  It has a line of
+// 16 hexadecimal digits for each entry, giving the offset of the entry
+// in the body, in the order of the paths.  The fixed width lets a
+// reader find a path by a binary search without reading the rest of
+// the file.  The entries of all sections follow:
+//
+//   <full path of the file>
+//   <modification time> <size>
+//   <included file>
+//   <full path in the directory of the file if quoted, or '->
+//   ...
+//   <empty line>
+bool cmDependsCDatabase::ReadHeader(std::istream& fin,
+                                    SectionsType& sections,
+                                    cmIML_INT_uint64_t& checked)
+{
+  std::string line;
+  if(!std::getline(fin, line) || line != INCLUDE_SCAN_DATABASE_MAGIC ||
+     !std::getline(fin, line) ||
+     sscanf(line.c_str(), INCLUDE_SCAN_CHECKED_MARKER "%" cmIML_INT_SCNu64,
+            &checked) != 1)
+    {
+    return false;
+    }
+  while(std::getline(fin, line) && !line.empty())
+    {
+    cmIML_INT_uint64_t count;
+    cmIML_INT_uint64_t index;
+    if(sscanf(line.c_str(), INCLUDE_SCAN_SECTION_MARKER
+              "%" cmIML_INT_SCNu64 " %" cmIML_INT_SCNu64,
+              &count, &index) != 2)
+      {
+      return false;
+      }
+
+    // The rules are the three lines that follow.
+    std::string rules;
+    for(int i = 0; i < 3; ++i)
+      {
+      if(!std::getline(fin, line))
+        {
+        return false;
+        }
+      if(i > 0)
+        {
+        rules += "\n";
+        }
+      rules += line;
+      }
+    cmDependsCSection& section = sections[rules];
+    section.Count = count;
+    section.Index = index;
+    }
+  return fin? true : false;
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsCDatabase::ReadLines(std::istream& fin,
+                                   cmDependsC::cmIncludeLines& lines)
+{
+  // Read the rest of an entry after its path.
+  std::string line;
+  if(!std::getline(fin, line) ||
+     sscanf(line.c_str(), "%" cmIML_INT_SCNu64 " %" cmIML_INT_SCNu64,
+            &lines.Stamp.Time, &lines.Stamp.Size) != 2)
+    {
+    return false;
+    }
+  lines.HasStamp = true;
+  lines.UnscannedEntries.clear();
+  while(std::getline(fin, line) && !line.empty())
+    {
+    cmDependsC::UnscannedEntry inc;
+    inc.FileName = line;
+    if(!std::getline(fin, line))
+      {
+      return false;
+      }
+    if(line != "-")
+      {
+      inc.QuotedLocation = line;
+      }
+    lines.UnscannedEntries.push_back(inc);
+    }
+  return fin? true : false;
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsCDatabase::Read(std::string const& fname,
+                              SectionsType& sections,
+                              cmIML_INT_uint64_t& checked)
+{
+  cmsys::ifstream fin(fname.c_str(), std::ios::in | std::ios::binary);
+  if(!fin || !ReadHeader(fin, sections, checked))
+    {
+    return false;
+    }
+
+  // Skip the indexes.  The entries follow in the order of the sections.
+  cmIML_INT_uint64_t count = 0;
+  for(SectionsType::const_iterator si = sections.begin();
+      si != sections.end(); ++si)
+    {
+    count += si->second.Count;
+    }
+  fin.seekg(static_cast<std::streamoff>(count * INCLUDE_SCAN_INDEX_WIDTH),
+            std::ios::cur);
+
+  std::string path;
+  for(SectionsType::iterator si = sections.begin();
+      si != sections.end(); ++si)
+    {
+    for(cmIML_INT_uint64_t i = 0; i < si->second.Count; ++i)
+      {
+      if(!std::getline(fin, path) ||
+         !ReadLines(fin, si->second.Entries[path]))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsCDatabase::Write(std::string const& fname,
+                               SectionsType const& sections,
+                               cmIML_INT_uint64_t checked,
+                               bool scannedOnly)
+{
+  // Lay out the entries first to know their offsets for the index.
+  char buf[64];
+  sprintf(buf, "%" cmIML_INT_PRIu64, checked);
+  std::string header = INCLUDE_SCAN_DATABASE_MAGIC "\n";
+  header += INCLUDE_SCAN_CHECKED_MARKER;
+  header += buf;
+  header += "\n";
+  std::string entries;
+  std::vector<cmIML_INT_uint64_t> offsets;
+  for(SectionsType::const_iterator si = sections.begin();
+      si != sections.end(); ++si)
+    {
+    cmIML_INT_uint64_t first = offsets.size();
+    for(FileCacheType::const_iterator fi = si->second.Entries.begin();
+        fi != si->second.Entries.end(); ++fi)
+      {
+      cmDependsC::cmIncludeLines const& lines = fi->second;
+      if(!lines.HasStamp || (scannedOnly && !lines.Scanned))
+        {
+        continue;
+        }
+      offsets.push_back(entries.size());
+      sprintf(buf, "%" cmIML_INT_PRIu64 " %" cmIML_INT_PRIu64,
+              lines.Stamp.Time, lines.Stamp.Size);
+      entries += fi->first;
+      entries += "\n";
+      entries += buf;
+      entries += "\n";
+      for(std::vector<cmDependsC::UnscannedEntry>::const_iterator
+            ii = lines.UnscannedEntries.begin();
+          ii != lines.UnscannedEntries.end(); ++ii)
+        {
+        entries += ii->FileName;
+        entries += "\n";
+        entries += ii->QuotedLocation.empty()? "-" : ii->QuotedLocation;
+        entries += "\n";
+        }
+      entries += "\n";
+      }
+    if(offsets.size() > first)
+      {
+      sprintf(buf, "%" cmIML_INT_PRIu64 " %" cmIML_INT_PRIu64,
+              static_cast<cmIML_INT_uint64_t>(offsets.size() - first),
+              first * INCLUDE_SCAN_INDEX_WIDTH);
+      header += INCLUDE_SCAN_SECTION_MARKER;
+      header += buf;
+      header += "\n";
+      header += si->first;
+      header += "\n";
+      }
+    }
+  header += "\n";
+
+  // Write a temporary file and move it into place so that a reader
+  // never sees a partial file.
+  sprintf(buf, ".tmp%u", cmSystemTools::RandomSeed());
+  std::string tmp = fname + buf;
+  {
+  cmsys::ofstream fout(tmp.c_str(), std::ios::out | std::ios::binary);
+  if(!fout)
+    {
+    return false;
+    }
+  fout << header;
+  cmIML_INT_uint64_t indexSize = offsets.size() * INCLUDE_SCAN_INDEX_WIDTH;
+  for(std::vector<cmIML_INT_uint64_t>::const_iterator oi = offsets.begin();
+      oi != offsets.end(); ++oi)
+    {
+    sprintf(buf, "%016" cmIML_INT_PRIx64 "\n", indexSize + *oi);
+    fout << buf;
+    }
+  fout << entries;
+  if(!fout)
+    {
+    fout.close();
+    cmSystemTools::RemoveFile(tmp.c_str());
+    return false;
+    }
+  }
+  if(!cmSystemTools::RenameFile(tmp.c_str(), fname.c_str()))
+    {
+    cmSystemTools::RemoveFile(tmp.c_str());
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmDependsCDatabase::Load(std::string const& homeOutputDir,
+                              std::string const& targetDir)
+{
+  if(!this->TargetFile.empty())
+    {
+    return;
+    }
+
+  // Name the file of the target after its directory in the build tree.
+  // Escape '_' so that two directories never map to the same name.
+  std::string rel =
+    cmSystemTools::RelativePath(homeOutputDir.c_str(), targetDir.c_str());
+  this->TargetFile = homeOutputDir;
+  this->TargetFile += cmake::GetCMakeFilesDirectory();
+  this->TargetFile += INCLUDE_SCAN_TARGETS_DIR "/";
+  for(std::string::const_iterator ci = rel.begin(); ci != rel.end(); ++ci)
+    {
+    if(*ci == '/')
+      {
+      this->TargetFile += "_s";
+      }
+    else if(*ci == '_')
+      {
+      this->TargetFile += "__";
+      }
+    else
+      {
+      this->TargetFile += *ci;
+      }
+    }
+  this->TargetFile += ".scan";
+
+  // Read only the header now.  The entries are looked up when reached.
+  std::string dbFile = homeOutputDir;
+  dbFile += cmake::GetCMakeFilesDirectory();
+  dbFile += INCLUDE_SCAN_DATABASE_FILE;
+  this->File.open(dbFile.c_str(), std::ios::in | std::ios::binary);
+  SectionsType sections;
+  cmIML_INT_uint64_t checked;
+  if(!this->File || !ReadHeader(this->File, sections, checked))
+    {
+    this->File.close();
+    return;
+    }
+  this->Body = static_cast<cmIML_INT_uint64_t>(this->File.tellg());
+  for(SectionsType::const_iterator si = sections.begin();
+      si != sections.end(); ++si)
+    {
+    cmDependsCSection& section = this->Sections[si->first];
+    section.Count = si->second.Count;
+    section.Index = si->second.Index;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsCDatabase::Find(cmDependsCSection const& section,
+                              std::string const& path,
+                              cmDependsC::cmIncludeLines& lines)
+{
+  if(!this->File.is_open())
+    {
+    return false;
+    }
+
+  // Search the index of the section for the path.
+  char buf[INCLUDE_SCAN_INDEX_WIDTH + 1];
+  buf[INCLUDE_SCAN_INDEX_WIDTH] = 0;
+  std::string line;
+  cmIML_INT_uint64_t first = 0;
+  cmIML_INT_uint64_t last = section.Count;
+  while(first < last)
+    {
+    cmIML_INT_uint64_t mid = first + (last - first) / 2;
+    cmIML_INT_uint64_t offset;
+    this->File.seekg(static_cast<std::streamoff>(
+      this->Body + section.Index + mid * INCLUDE_SCAN_INDEX_WIDTH));
+    if(!this->File.read(buf, INCLUDE_SCAN_INDEX_WIDTH) ||
+       sscanf(buf, "%" cmIML_INT_SCNx64, &offset) != 1)
+      {
+      break;
+      }
+    this->File.seekg(static_cast<std::streamoff>(this->Body + offset));
+    if(!std::getline(this->File, line))
+      {
+      break;
+      }
+    int cmp = line.compare(path);
+    if(cmp < 0)
+      {
+      first = mid + 1;
+      }
+    else if(cmp > 0)
+      {
+      last = mid;
+      }
+    else if(ReadLines(this->File, lines))
+      {
+      return true;
+      }
+    else
+      {
+      break;
+      }
+    }
+
+  // A damaged file is not read any further.
+  if(!this->File)
+    {
+    this->File.close();
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void cmDependsCDatabase::Save()
+{
+  // A run that scanned nothing leaves the entries saved by an earlier
+  // run that has not been merged yet.
+  if(!this->Scanned || this->TargetFile.empty())
+    {
+    return;
+    }
+  this->Scanned = false;
+
+  // Save only the entries scanned in this run.  The others are in the
+  // database already.
+  cmSystemTools::MakeDirectory(
+    cmSystemTools::GetFilenamePath(this->TargetFile).c_str());
+  Write(this->TargetFile, this->Sections, 0, true);
+}
+
+//----------------------------------------------------------------------------
+void cmDependsCDatabase::Merge(std::string const& homeOutputDir)
+{
+  std::string dir = homeOutputDir;
+  dir += cmake::GetCMakeFilesDirectory();
+  std::string targetsDir = dir + INCLUDE_SCAN_TARGETS_DIR;
+  cmsys::Directory d;
+  if(!d.Load(targetsDir.c_str()))
+    {
+    return;
+    }
+  std::vector<std::string> targetFiles;
+  for(unsigned long i = 0; i < d.GetNumberOfFiles(); ++i)
+    {
+    std::string fname = targetsDir + "/" + d.GetFile(i);
+    if(cmHasLiteralSuffix(fname, ".scan"))
+      {
+      targetFiles.push_back(fname);
+      }
+    }
+  if(targetFiles.empty())
+    {
+    return;
+    }
+
+  // Replace the entries of the database with those scanned since.
+  std::string dbFile = dir + INCLUDE_SCAN_DATABASE_FILE;
+  SectionsType sections;
+  cmIML_INT_uint64_t checked = 0;
+  if(!Read(dbFile, sections, checked))
+    {
+    sections.clear();
+    checked = 0;
+    }
+  for(std::vector<std::string>::const_iterator ti = targetFiles.begin();
+      ti != targetFiles.end(); ++ti)
+    {
+    SectionsType target;
+    cmIML_INT_uint64_t targetChecked;
+    if(!Read(*ti, target, targetChecked))
+      {
+      continue;
+      }
+    for(SectionsType::iterator si = target.begin();
+        si != target.end(); ++si)
+      {
+      FileCacheType& section = sections[si->first].Entries;
+      for(FileCacheType::iterator fi = si->second.Entries.begin();
+          fi != si->second.Entries.end(); ++fi)
+        {
+        section[fi->first] = fi->second;
+        }
+      }
+    }
+
+  // Entries are replaced when their files are scanned again, but those
+  // of removed files would stay.  Check all entries only when their
+  // number has doubled since the last check, so that checking costs
+  // no more than a constant factor of the scanning done meanwhile.
+  cmIML_INT_uint64_t count = 0;
+  for(SectionsType::const_iterator si = sections.begin();
+      si != sections.end(); ++si)
+    {
+    count += si->second.Entries.size();
+    }
+  if(count > 2 * checked)
+    {
+    count = 0;
+    for(SectionsType::iterator si = sections.begin();
+        si != sections.end(); ++si)
+      {
+      FileCacheType& section = si->second.Entries;
+      for(FileCacheType::iterator fi = section.begin(); fi != section.end();)
+        {
+        // Included files found in a relative include directory have
+        // paths relative to the build tree.
+        std::string path = fi->first;
+        if(!cmSystemTools::FileIsFullPath(path.c_str()))
+          {
+          path = homeOutputDir + "/" + path;
+          }
+        cmFileStamp stamp;
+        bool stable;
+        if(stamp.Load(path.c_str(), stable) && stamp == fi->second.Stamp)
+          {
+          ++fi;
+          ++count;
+          }
+        else
+          {
+          section.erase(fi++);
+          }
+        }
+      }
+    checked = count;
+    }
+
+  // Remove the files of the targets only once their entries are safe.
+  if(Write(dbFile, sections, checked, false))
+    {
+    for(std::vector<std::string>::const_iterator ti = targetFiles.begin();
+        ti != targetFiles.end(); ++ti)
+      {
+      cmSystemTools::RemoveFile(ti->c_str());
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmDependsC::MergeIncludeScans(std::string const& homeOutputDir)
+{
+  cmDependsCDatabase::Merge(homeOutputDir);
+}
+
 //----------------------------------------------------------------------------
 cmDependsC::cmDependsC()
 : ValidDeps(0)
+, Database(&cmDependsCDatabase::GetInstance())
+, Section(&Database->GetSection(""))
 {
 }
 
@@ -41,6 +605,7 @@ cmDependsC::cmDependsC(cmLocalGenerator* lg,
                    const std::map<std::string, DependencyVector>* validDeps)
 : cmDepends(lg, targetDir)
 , ValidDeps(validDeps)
+, Database(&cmDependsCDatabase::GetInstance())
 {
   cmMakefile* mf = lg->GetMakefile();
 
@@ -73,29 +638,49 @@ cmDependsC::cmDependsC(cmLocalGenerator* lg,
   this->IncludeRegexLineString = INCLUDE_REGEX_LINE_MARKER INCLUDE_REGEX_LINE;
   this->IncludeRegexScanString = INCLUDE_REGEX_SCAN_MARKER;
   this->IncludeRegexScanString += scanRegex;
-  this->IncludeRegexComplainString = INCLUDE_REGEX_COMPLAIN_MARKER;
-  this->IncludeRegexComplainString += complainRegex;
 
   this->SetupTransforms();
 
-  this->CacheFileName = this->TargetDirectory;
-  this->CacheFileName += "/";
-  this->CacheFileName += lang;
-  this->CacheFileName += ".includecache";
-
-  this->ReadCacheFile();
+  // Use the section of the include scan database for our rules.
+  this->Database->Load(mf->GetHomeOutputDirectory(), targetDir);
+  this->Section = &this->Database->GetSection(
+    this->IncludeRegexLineString + "\n" +
+    this->IncludeRegexScanString + "\n" +
+    this->IncludeRegexTransformString);
 }
 
 //----------------------------------------------------------------------------
 cmDependsC::~cmDependsC()
 {
-  this->WriteCacheFile();
+  this->Database->Save();
+}
+
+//----------------------------------------------------------------------------
+cmDependsC::cmIncludeLines const*
+cmDependsC::GetIncludeLines(std::string const& fullName)
+{
+  FileCacheType& entries = this->Section->Entries;
+  FileCacheType::iterator fileIt = entries.find(fullName);
+  if(fileIt != entries.end())
+    {
+    return &fileIt->second;
+    }
 
-  for (std::map<std::string, cmIncludeLines*>::iterator it=
-         this->FileCache.begin(); it!=this->FileCache.end(); ++it)
+  // Look the file up in the database.  Use its entry only if the file
+  // has not changed since it was scanned.
+  cmIncludeLines lines;
+  cmFileStamp stamp;
+  bool stable;
+  if(!this->Database->Find(*this->Section, fullName, lines) ||
+     !stamp.Load(fullName.c_str(), stable) || stamp != lines.Stamp)
     {
-    delete it->second;
+    return 0;
     }
+  cmIncludeLines& entry = entries[fullName];
+  entry.UnscannedEntries.swap(lines.UnscannedEntries);
+  entry.Stamp = lines.Stamp;
+  entry.HasStamp = true;
+  return &entry;
 }
 
 //----------------------------------------------------------------------------
@@ -224,15 +809,12 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
         scanned.insert(fullName);
 
         // Check whether this file is already in the cache
-        std::map<std::string, cmIncludeLines*>::iterator fileIt=
-          this->FileCache.find(fullName);
-        if (fileIt!=this->FileCache.end())
+        if (cmIncludeLines const* lines = this->GetIncludeLines(fullName))
           {
-          fileIt->second->Used=true;
           dependencies.insert(fullName);
           for (std::vector<UnscannedEntry>::const_iterator incIt=
-                fileIt->second->UnscannedEntries.begin();
-              incIt!=fileIt->second->UnscannedEntries.end(); ++incIt)
+                lines->UnscannedEntries.begin();
+              incIt!=lines->UnscannedEntries.end(); ++incIt)
             {
             if (this->Encountered.find(incIt->FileName) ==
                 this->Encountered.end())
@@ -291,147 +873,20 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
   return true;
 }
 
-//----------------------------------------------------------------------------
-void cmDependsC::ReadCacheFile()
-{
-  if(this->CacheFileName.size() == 0)
-    {
-    return;
-    }
-  cmsys::ifstream fin(this->CacheFileName.c_str());
-  if(!fin)
-    {
-    return;
-    }
-
-  std::string line;
-  cmIncludeLines* cacheEntry=0;
-  bool haveFileName=false;
-
-  while(cmSystemTools::GetLineFromStream(fin, line))
-    {
-    if (line.empty())
-      {
-      cacheEntry=0;
-      haveFileName=false;
-      continue;
-      }
-    //the first line after an empty line is the name of the parsed file
-    if (haveFileName==false)
-      {
-      haveFileName=true;
-      int newer=0;
-      cmFileTimeComparison comp;
-      bool res=comp.FileTimeCompare(this->CacheFileName.c_str(),
-                                    line.c_str(), &newer);
-
-      if ((res==true) && (newer==1)) //cache is newer than the parsed file
-        {
-        cacheEntry=new cmIncludeLines;
-        this->FileCache[line]=cacheEntry;
-        }
-      // file doesn't exist, check that the regular expressions
-      // haven't changed
-      else if (res==false)
-        {
-        if (line.find(INCLUDE_REGEX_LINE_MARKER) == 0)
-          {
-          if (line != this->IncludeRegexLineString)
-            {
-            return;
-            }
-          }
-        else if (line.find(INCLUDE_REGEX_SCAN_MARKER) == 0)
-          {
-          if (line != this->IncludeRegexScanString)
-            {
-            return;
-            }
-          }
-        else if (line.find(INCLUDE_REGEX_COMPLAIN_MARKER) == 0)
-          {
-          if (line != this->IncludeRegexComplainString)
-            {
-            return;
-            }
-          }
-        else if (line.find(INCLUDE_REGEX_TRANSFORM_MARKER) == 0)
-          {
-          if (line != this->IncludeRegexTransformString)
-            {
-            return;
-            }
-          }
-        }
-      }
-    else if (cacheEntry!=0)
-      {
-      UnscannedEntry entry;
-      entry.FileName = line;
-      if (cmSystemTools::GetLineFromStream(fin, line))
-        {
-        if (line!="-")
-          {
-          entry.QuotedLocation=line;
-          }
-        cacheEntry->UnscannedEntries.push_back(entry);
-        }
-      }
-    }
-}
-
-//----------------------------------------------------------------------------
-void cmDependsC::WriteCacheFile() const
-{
-  if(this->CacheFileName.size() == 0)
-    {
-    return;
-    }
-  cmsys::ofstream cacheOut(this->CacheFileName.c_str());
-  if(!cacheOut)
-    {
-    return;
-    }
-
-  cacheOut << this->IncludeRegexLineString << "\n\n";
-  cacheOut << this->IncludeRegexScanString << "\n\n";
-  cacheOut << this->IncludeRegexComplainString << "\n\n";
-  cacheOut << this->IncludeRegexTransformString << "\n\n";
-
-  for (std::map<std::string, cmIncludeLines*>::const_iterator fileIt=
-         this->FileCache.begin();
-       fileIt!=this->FileCache.end(); ++fileIt)
-    {
-    if (fileIt->second->Used)
-      {
-      cacheOut<<fileIt->first.c_str()<<std::endl;
-
-      for (std::vector<UnscannedEntry>::const_iterator
-             incIt=fileIt->second->UnscannedEntries.begin();
-           incIt!=fileIt->second->UnscannedEntries.end(); ++incIt)
-        {
-        cacheOut<<incIt->FileName.c_str()<<std::endl;
-        if (incIt->QuotedLocation.empty())
-          {
-          cacheOut<<"-"<<std::endl;
-          }
-        else
-          {
-          cacheOut<<incIt->QuotedLocation.c_str()<<std::endl;
-          }
-        }
-      cacheOut<<std::endl;
-      }
-   }
-}
-
 //----------------------------------------------------------------------------
 void cmDependsC::Scan(std::istream& is, const char* directory,
   const std::string& fullName)
 {
-  cmIncludeLines* newCacheEntry=new cmIncludeLines;
-  newCacheEntry->Used=true;
-  this->FileCache[fullName]=newCacheEntry;
+  cmIncludeLines* newCacheEntry=&this->Section->Entries[fullName];
+  newCacheEntry->UnscannedEntries.clear();
+  newCacheEntry->Scanned=true;
+
+  // Record the stamp of the file before reading it.  If it is modified
+  // meanwhile the stamp will not match later and the file is rescanned.
+  bool stable = false;
+  newCacheEntry->HasStamp =
+    newCacheEntry->Stamp.Load(fullName.c_str(), stable) && stable;
+  this->Database->SetScanned();
 
   // Read one line at a time.
   std::string line;
@@ -13,9 +13,13 @@
 #define cmDependsC_h
 
 #include "cmDepends.h"
+#include "cmFileStamp.h"
 #include <cmsys/RegularExpression.hxx>
 #include <queue>
 
+class cmDependsCDatabase;
+class cmDependsCSection;
+
 /** \class cmDependsC
  * \brief Dependency scanner for C and C++ object files.
  */
@@ -32,6 +36,11 @@ public:
   /** Virtual destructor to cleanup subclasses properly.  */
   virtual ~cmDependsC();
 
+  /** Merge the include scans saved by the targets of the build tree
+      into its include scan database.  This must not run concurrently
+      with the dependency scanning of any target.  */
+  static void MergeIncludeScans(std::string const& homeOutputDir);
+
 protected:
   // Implement writing/checking methods required by superclass.
   virtual bool WriteDependencies(const std::set<std::string>& sources,
@@ -52,7 +61,6 @@ protected:
   cmsys::RegularExpression IncludeRegexComplain;
   std::string IncludeRegexLineString;
   std::string IncludeRegexScanString;
-  std::string IncludeRegexComplainString;
 
   // Regex to transform #include lines.
   std::string IncludeRegexTransformString;
@@ -73,22 +81,32 @@ public:
 
   struct cmIncludeLines
   {
-    cmIncludeLines(): Used(false) {}
+    cmIncludeLines(): HasStamp(false), Scanned(false) {}
     std::vector<UnscannedEntry> UnscannedEntries;
-    bool Used;
+
+    // The stamp of the file when it was scanned, if it was stable.
+    cmFileStamp Stamp;
+    bool HasStamp;
+
+    // Whether the file was scanned by this process.  Only these entries
+    // are saved for the target.
+    bool Scanned;
   };
+  typedef std::map<std::string, cmIncludeLines> FileCacheType;
 protected:
   const std::map<std::string, DependencyVector>* ValidDeps;
   std::set<std::string> Encountered;
   std::queue<UnscannedEntry> Unscanned;
 
-  std::map<std::string, cmIncludeLines *> FileCache;
-  std::map<std::string, std::string> HeaderLocationCache;
-
-  std::string CacheFileName;
+  // The include lines of scanned files.  This is the section of the
+  // build tree's include scan database for the regular expressions
+  // and transforms of this instance, shared by all instances in this
+  // process.
+  cmDependsCDatabase* Database;
+  cmDependsCSection* Section;
+  cmIncludeLines const* GetIncludeLines(std::string const& fullName);
 
-  void WriteCacheFile() const;
-  void ReadCacheFile();
+  std::map<std::string, std::string> HeaderLocationCache;
 private:
   cmDependsC(cmDependsC const&); // Purposely not implemented.
   void operator=(cmDependsC const&); // Purposely not implemented.
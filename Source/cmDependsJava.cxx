@@ -39,7 +39,7 @@ bool cmDependsJava::WriteDependencies(const std::set<std::string>& sources,
 }
 
 bool cmDependsJava::CheckDependencies(std::istream&, const char*,
-                             std::map<std::string, DependencyVector >&)
+                             std::map<std::string, DependencyVector >*)
 {
   return true;
 }
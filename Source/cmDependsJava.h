@@ -34,7 +34,7 @@ protected:
     std::ostream& makeDepends, std::ostream& internalDepends);
   virtual bool CheckDependencies(std::istream& internalDepends,
                                  const char* internalDependsFileName,
-                           std::map<std::string, DependencyVector>& validDeps);
+                           std::map<std::string, DependencyVector>* validDeps);
 
 private:
   cmDependsJava(cmDependsJava const&); // Purposely not implemented.
@@ -47,6 +47,11 @@ public:
    */
   virtual std::string GetName() const { return "endif";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmEndIfCommand, cmCommand);
 };
 
@@ -54,6 +54,11 @@ public:
    */
   virtual std::string GetName() const { return "endwhile";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmEndWhileCommand, cmCommand);
 };
 
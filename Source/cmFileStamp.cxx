@@ -0,0 +1,71 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmFileStamp.h"
+
+#include <cmsys/Configure.hxx>
+#include <cmsys/Encoding.hxx>
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+# include <sys/stat.h>
+# include <time.h>
+#else
+# include <windows.h>
+#endif
+
+//----------------------------------------------------------------------------
+bool cmFileStamp::Load(const char* path, bool& stable)
+{
+#if !defined(_WIN32) || defined(__CYGWIN__)
+  struct stat st;
+  if(::stat(path, &st) != 0)
+    {
+    return false;
+    }
+  cmIML_INT_uint64_t sec = static_cast<cmIML_INT_uint64_t>(st.st_mtime);
+# if cmsys_STAT_HAS_ST_MTIM
+  this->Time = sec * 1000000000 + st.st_mtim.tv_nsec;
+# else
+  this->Time = sec * 1000000000;
+# endif
+  this->Size = static_cast<cmIML_INT_uint64_t>(st.st_size);
+
+  // A file modified within the last couple of seconds may be modified
+  // again without a visible change in time on file systems with coarse
+  // timestamps.
+  cmIML_INT_uint64_t now = static_cast<cmIML_INT_uint64_t>(time(0));
+  stable = sec + 2 <= now;
+#else
+  WIN32_FILE_ATTRIBUTE_DATA fdata;
+  if(!GetFileAttributesExW(cmsys::Encoding::ToWide(path).c_str(),
+                           GetFileExInfoStandard, &fdata))
+    {
+    return false;
+    }
+  ULARGE_INTEGER t;
+  t.LowPart = fdata.ftLastWriteTime.dwLowDateTime;
+  t.HighPart = fdata.ftLastWriteTime.dwHighDateTime;
+  ULARGE_INTEGER n;
+  n.LowPart = fdata.nFileSizeLow;
+  n.HighPart = fdata.nFileSizeHigh;
+  this->Time = t.QuadPart;
+  this->Size = n.QuadPart;
+
+  // See the comment above.  FILETIME is in units of 100ns.
+  FILETIME nowft;
+  GetSystemTimeAsFileTime(&nowft);
+  ULARGE_INTEGER now;
+  now.LowPart = nowft.dwLowDateTime;
+  now.HighPart = nowft.dwHighDateTime;
+  stable = t.QuadPart + 20000000 <= now.QuadPart;
+#endif
+  return true;
+}
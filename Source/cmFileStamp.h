@@ -0,0 +1,54 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmFileStamp_h
+#define cmFileStamp_h
+
+#include "cmStandardIncludes.h"
+
+/** \class cmFileStamp
+ * \brief Modification time and size of a file.
+ *
+ * Equal stamps taken of a file at two different times show that the
+ * file was not modified in between, unless the file was modified
+ * shortly before the first stamp was taken.  Such a stamp is not
+ * stable because file systems with coarse timestamps may not show a
+ * following modification.
+ */
+class cmFileStamp
+{
+public:
+  cmFileStamp(): Time(0), Size(0) {}
+
+  /**
+   * Stamp the given file.  Returns false if it does not exist.  Sets
+   * stable to whether the stamp can be trusted to detect a later
+   * modification.
+   */
+  bool Load(const char* path, bool& stable);
+
+  bool operator==(cmFileStamp const& r) const
+    {
+    return this->Time == r.Time && this->Size == r.Size;
+    }
+  bool operator!=(cmFileStamp const& r) const
+    {
+    return !(*this == r);
+    }
+
+  /** Modification time in a platform-specific unit.  */
+  cmIML_INT_uint64_t Time;
+
+  /** Size in bytes.  */
+  cmIML_INT_uint64_t Size;
+};
+
+#endif
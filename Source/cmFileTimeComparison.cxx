@@ -37,6 +37,8 @@ public:
 
   bool FileTimesDiffer(const char* f1, const char* f2);
 
+  inline bool FileExists(const char* fname);
+
 private:
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   // Use a hash table to efficiently map from file name to modification time.
@@ -131,6 +133,12 @@ bool cmFileTimeComparison::FileTimesDiffer(const char* f1, const char* f2)
   return this->Internals->FileTimesDiffer(f1, f2);
 }
 
+//----------------------------------------------------------------------------
+bool cmFileTimeComparison::FileExists(const char* fname)
+{
+  return this->Internals->FileExists(fname);
+}
+
 //----------------------------------------------------------------------------
 int cmFileTimeComparisonInternal::Compare(cmFileTimeComparison_Type* s1,
                                           cmFileTimeComparison_Type* s2)
@@ -275,3 +283,11 @@ bool cmFileTimeComparisonInternal::FileTimesDiffer(const char* f1,
     return true;
     }
 }
+
+//----------------------------------------------------------------------------
+bool cmFileTimeComparisonInternal::FileExists(const char* fname)
+{
+  // The file exists if its modification time is available.
+  cmFileTimeComparison_Type st;
+  return this->Stat(fname, &st);
+}
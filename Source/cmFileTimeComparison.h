@@ -41,6 +41,12 @@ public:
    */
   bool FileTimesDiffer(const char* f1, const char* f2);
 
+  /**
+   *  Return whether a file exists.  A file found to exist is not
+   *  looked up on disk again by later calls or time comparisons.
+   */
+  bool FileExists(const char* fname);
+
 protected:
 
   cmFileTimeComparisonInternal* Internals;
@@ -13,14 +13,48 @@
 
 #include "cmake.h"
 
+//----------------------------------------------------------------------------
+// The recorded body of a function.  It is shared by the prototype
+// command and all clones made to invoke it.
+class cmFunctionBody
+{
+public:
+  cmFunctionBody(): ReferenceCount(1) {}
+
+  void Register() { ++this->ReferenceCount; }
+  void UnRegister()
+    {
+    if(--this->ReferenceCount == 0)
+      {
+      delete this;
+      }
+    }
+
+  std::vector<std::string> Args;
+  std::vector<cmListFileFunction> Functions;
+  cmPolicies::PolicyMap Policies;
+
+  // The names ARGV0, ARGV1, ... of the arguments seen so far.
+  std::vector<std::string> ArgVNames;
+private:
+  unsigned int ReferenceCount;
+};
+
+//----------------------------------------------------------------------------
 // define the class for function commands
 class cmFunctionHelperCommand : public cmCommand
 {
 public:
-  cmFunctionHelperCommand() {}
+  cmFunctionHelperCommand(cmFunctionBody* body): Body(body)
+    {
+    this->Body->Register();
+    }
 
   ///! clean up any memory allocated by the function
-  ~cmFunctionHelperCommand() {}
+  ~cmFunctionHelperCommand()
+    {
+    this->Body->UnRegister();
+    }
 
   /**
    * This is used to avoid including this command
@@ -34,16 +68,13 @@ public:
     }
 
   /**
-   * This is a virtual constructor for the command.
+   * This is a virtual constructor for the command.  The clone shares
+   * the recorded body, which outlives the prototype if the function is
+   * redefined while it runs.
    */
   virtual cmCommand* Clone()
   {
-    cmFunctionHelperCommand *newC = new cmFunctionHelperCommand;
-    // we must copy when we clone
-    newC->Args = this->Args;
-    newC->Functions = this->Functions;
-    newC->Policies = this->Policies;
-    return newC;
+    return new cmFunctionHelperCommand(this->Body);
   }
 
   /**
@@ -64,13 +95,12 @@ public:
   /**
    * The name of the command as specified in CMakeList.txt.
    */
-  virtual std::string GetName() const { return this->Args[0]; }
+  virtual std::string GetName() const { return this->Body->Args[0]; }
 
   cmTypeMacro(cmFunctionHelperCommand, cmCommand);
 
-  std::vector<std::string> Args;
-  std::vector<cmListFileFunction> Functions;
-  cmPolicies::PolicyMap Policies;
+private:
+  cmFunctionBody* Body;
 };
 
 
@@ -82,13 +112,15 @@ bool cmFunctionHelperCommand::InvokeInitialPass
   std::vector<std::string> expandedArgs;
   this->Makefile->ExpandArguments(args, expandedArgs);
 
+  cmFunctionBody* body = this->Body;
+
   // make sure the number of arguments passed is at least the number
   // required by the signature
-  if (expandedArgs.size() < this->Args.size() - 1)
+  if (expandedArgs.size() < body->Args.size() - 1)
     {
     std::string errorMsg =
       "Function invoked with incorrect arguments for function named: ";
-    errorMsg += this->Args[0];
+    errorMsg += body->Args[0];
     this->SetError(errorMsg);
     return false;
     }
@@ -100,28 +132,33 @@ bool cmFunctionHelperCommand::InvokeInitialPass
 
   // Push a weak policy scope which restores the policies recorded at
   // function creation.
-  cmMakefile::PolicyPushPop polScope(this->Makefile, true, this->Policies);
+  cmMakefile::PolicyPushPop polScope(this->Makefile, true, body->Policies);
 
   // set the value of argc
-  cmOStringStream strStream;
-  strStream << expandedArgs.size();
-  this->Makefile->AddDefinition("ARGC",strStream.str().c_str());
+  char argc[32];
+  sprintf(argc, "%u", static_cast<unsigned int>(expandedArgs.size()));
+  this->Makefile->AddDefinition("ARGC", argc);
   this->Makefile->MarkVariableAsUsed("ARGC");
 
   // set the values for ARGV0 ARGV1 ...
+  while (body->ArgVNames.size() < expandedArgs.size())
+    {
+    char argvName[32];
+    sprintf(argvName, "ARGV%u",
+            static_cast<unsigned int>(body->ArgVNames.size()));
+    body->ArgVNames.push_back(argvName);
+    }
   for (unsigned int t = 0; t < expandedArgs.size(); ++t)
     {
-    cmOStringStream tmpStream;
-    tmpStream << "ARGV" << t;
-    this->Makefile->AddDefinition(tmpStream.str(),
+    this->Makefile->AddDefinition(body->ArgVNames[t],
                                   expandedArgs[t].c_str());
-    this->Makefile->MarkVariableAsUsed(tmpStream.str());
+    this->Makefile->MarkVariableAsUsed(body->ArgVNames[t]);
     }
 
   // define the formal arguments
-  for (unsigned int j = 1; j < this->Args.size(); ++j)
+  for (unsigned int j = 1; j < body->Args.size(); ++j)
     {
-    this->Makefile->AddDefinition(this->Args[j],
+    this->Makefile->AddDefinition(body->Args[j],
                                   expandedArgs[j-1].c_str());
     }
 
@@ -137,7 +174,7 @@ bool cmFunctionHelperCommand::InvokeInitialPass
       argvDef += ";";
       }
     argvDef += *eit;
-    if ( cnt >= this->Args.size()-1 )
+    if ( cnt >= body->Args.size()-1 )
       {
       if ( argnDef.size() > 0 )
         {
@@ -154,10 +191,10 @@ bool cmFunctionHelperCommand::InvokeInitialPass
 
   // Invoke all the functions that were collected in the block.
   // for each function
-  for(unsigned int c = 0; c < this->Functions.size(); ++c)
+  for(unsigned int c = 0; c < body->Functions.size(); ++c)
     {
     cmExecutionStatus status;
-    if (!this->Makefile->ExecuteCommand(this->Functions[c],status) ||
+    if (!this->Makefile->ExecuteCommand(body->Functions[c],status) ||
         status.GetNestedError())
       {
       // The error message should have already included the call stack
@@ -202,21 +239,23 @@ IsFunctionBlocked(const cmListFileFunction& lff, cmMakefile &mf,
       name += " )";
 
       // create a new command and add it to cmake
-      cmFunctionHelperCommand *f = new cmFunctionHelperCommand();
-      f->Args = this->Args;
-      f->Functions = this->Functions;
-      mf.RecordPolicies(f->Policies);
+      cmFunctionBody* body = new cmFunctionBody;
+      body->Args = this->Args;
+      body->Functions = this->Functions;
+      mf.RecordPolicies(body->Policies);
 
       // Set the FilePath on the arguments to match the function since it is
       // not stored and the original values may be freed
-      for (unsigned int i = 0; i < f->Functions.size(); ++i)
+      for (unsigned int i = 0; i < body->Functions.size(); ++i)
         {
-        for (unsigned int j = 0; j < f->Functions[i].Arguments.size(); ++j)
+        for (unsigned int j = 0; j < body->Functions[i].Arguments.size(); ++j)
           {
-          f->Functions[i].Arguments[j].FilePath =
-            f->Functions[i].FilePath.c_str();
+          body->Functions[i].Arguments[j].FilePath =
+            body->Functions[i].FilePath.c_str();
           }
         }
+      cmFunctionHelperCommand *f = new cmFunctionHelperCommand(body);
+      body->UnRegister();
 
       std::string newName = "_" + this->Args[0];
       mf.GetCMakeInstance()->RenameCommand(this->Args[0],
@@ -19,14 +19,16 @@
 
 //----------------------------------------------------------------------------
 cmGeneratedFileStream::cmGeneratedFileStream():
-  cmGeneratedFileStreamBase(), Stream()
+  cmGeneratedFileStreamBase(), Stream(), ContentBuffer(0), Binary(false)
 {
 }
 
 //----------------------------------------------------------------------------
 cmGeneratedFileStream::cmGeneratedFileStream(const char* name, bool quiet):
   cmGeneratedFileStreamBase(name),
-  Stream(TempName.c_str())
+  Stream(TempName.c_str()),
+  ContentBuffer(0),
+  Binary(false)
 {
   // Check if the file opened.
   if(!*this && !quiet)
@@ -45,6 +47,7 @@ cmGeneratedFileStream::~cmGeneratedFileStream()
   // stream will be destroyed which will close the temporary file.
   // Finally the base destructor will be called to replace the
   // destination file.
+  this->ReleaseContentBuffer();
   this->Okay = (*this)?true:false;
 }
 
@@ -56,6 +59,7 @@ cmGeneratedFileStream::Open(const char* name, bool quiet, bool binaryFlag)
   this->cmGeneratedFileStreamBase::Open(name);
 
   // Open the temporary output file.
+  this->Binary = binaryFlag;
   if ( binaryFlag )
     {
     this->Stream::open(this->TempName.c_str(),
@@ -80,6 +84,9 @@ cmGeneratedFileStream::Open(const char* name, bool quiet, bool binaryFlag)
 bool
 cmGeneratedFileStream::Close()
 {
+  // Compare or write out any content held in memory.
+  this->ReleaseContentBuffer();
+
   // Save whether the temporary output file is valid before closing.
   this->Okay = (*this)?true:false;
 
@@ -94,6 +101,109 @@ cmGeneratedFileStream::Close()
 void cmGeneratedFileStream::SetCopyIfDifferent(bool copy_if_different)
 {
   this->CopyIfDifferent = copy_if_different;
+
+  // If nothing has been written yet, collect the content in memory.
+  // Most regenerated files do not change, and this avoids writing and
+  // then re-reading a temporary copy of each of them.
+  if(this->CopyIfDifferent && !this->ContentBuffer &&
+     this->is_open() && *this && this->tellp() == 0)
+    {
+    this->ContentBuffer = new cmOStringStream;
+    this->std::ostream::rdbuf(this->ContentBuffer->rdbuf());
+    }
+}
+
+//----------------------------------------------------------------------------
+static bool cmGeneratedFileStreamDiffers(std::string const& content,
+                                         const char* fname)
+{
+  cmsys::ifstream fin(fname, std::ios::in | std::ios::binary);
+  if(!fin ||
+     cmSystemTools::FileLength(fname) != static_cast<unsigned long>(
+       content.size()))
+    {
+    return true;
+    }
+  const size_t BUFFER_SIZE = 4096;
+  char buffer[BUFFER_SIZE];
+  const char* expect = content.data();
+  size_t nleft = content.size();
+  while(nleft > 0)
+    {
+    size_t n = nleft < BUFFER_SIZE? nleft : BUFFER_SIZE;
+    fin.read(buffer, static_cast<std::streamsize>(n));
+    if(static_cast<size_t>(fin.gcount()) != n ||
+       memcmp(buffer, expect, n) != 0)
+      {
+      return true;
+      }
+    expect += n;
+    nleft -= n;
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void cmGeneratedFileStream::ReleaseContentBuffer()
+{
+  if(!this->ContentBuffer)
+    {
+    return;
+    }
+
+  // Switch back to the temporary file.  This clears the stream state,
+  // so restore a failure first recorded while writing to memory.
+  bool okay = (*this)?true:false;
+  std::string content = this->ContentBuffer->str();
+  this->std::ostream::rdbuf(this->Stream::rdbuf());
+  delete this->ContentBuffer;
+  this->ContentBuffer = 0;
+  if(!okay)
+    {
+    this->setstate(std::ios::failbit);
+    return;
+    }
+
+  // Leave the destination alone if its content is the same.
+  // Compressed output is compared after compression by the base.
+  if(this->CopyIfDifferent && !this->Compress && !this->Name.empty())
+    {
+    std::string const* expect = &content;
+#if defined(_WIN32)
+    // The text mode stream will write each newline as CR LF.
+    std::string crlf;
+    if(!this->Binary)
+      {
+      crlf.reserve(content.size());
+      for(std::string::const_iterator i = content.begin();
+          i != content.end(); ++i)
+        {
+        if(*i == '\n')
+          {
+          crlf += '\r';
+          }
+        crlf += *i;
+        }
+      expect = &crlf;
+      }
+#endif
+    this->ContentCompared = true;
+    this->ContentDiffers =
+      cmGeneratedFileStreamDiffers(*expect, this->Name.c_str());
+    if(!this->ContentDiffers)
+      {
+      return;
+      }
+    }
+
+  // Write the content to the temporary file and flush it so that a
+  // failure shows now rather than when the file is closed.
+  this->write(content.data(), static_cast<std::streamsize>(content.size()));
+  this->flush();
+  if(!*this)
+    {
+    this->Okay = false;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -115,7 +225,9 @@ cmGeneratedFileStreamBase::cmGeneratedFileStreamBase():
   CopyIfDifferent(false),
   Okay(false),
   Compress(false),
-  CompressExtraExtension(true)
+  CompressExtraExtension(true),
+  ContentCompared(false),
+  ContentDiffers(false)
 {
 }
 
@@ -126,7 +238,9 @@ cmGeneratedFileStreamBase::cmGeneratedFileStreamBase(const char* name):
   CopyIfDifferent(false),
   Okay(false),
   Compress(false),
-  CompressExtraExtension(true)
+  CompressExtraExtension(true),
+  ContentCompared(false),
+  ContentDiffers(false)
 {
   this->Open(name);
 }
@@ -142,6 +256,7 @@ void cmGeneratedFileStreamBase::Open(const char* name)
 {
   // Save the original name of the file.
   this->Name = name;
+  this->ContentCompared = false;
 
   // Create the name of the temporary file.
   this->TempName = name;
@@ -174,7 +289,8 @@ bool cmGeneratedFileStreamBase::Close()
   if(!this->Name.empty() &&
     this->Okay &&
     (!this->CopyIfDifferent ||
-     cmSystemTools::FilesDiffer(this->TempName.c_str(), resname.c_str())))
+     (this->ContentCompared? this->ContentDiffers :
+      cmSystemTools::FilesDiffer(this->TempName.c_str(), resname.c_str()))))
     {
     // The destination is to be replaced.  Rename the temporary to the
     // destination atomically.
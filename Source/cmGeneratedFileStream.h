@@ -65,6 +65,11 @@ protected:
 
   // Whether the destionation file is compressed
   bool CompressExtraExtension;
+
+  // Whether the content has already been compared to the destination
+  // file, and if so whether it differs.
+  bool ContentCompared;
+  bool ContentDiffers;
 };
 
 /** \class cmGeneratedFileStream
@@ -122,7 +127,10 @@ public:
   bool Close();
 
   /**
-   * Set whether copy-if-different is done.
+   * Set whether copy-if-different is done.  If nothing has been
+   * written yet the content is held in memory until the stream is
+   * closed, and the temporary file is written only if the content
+   * differs from the destination file.
    */
   void SetCopyIfDifferent(bool copy_if_different);
 
@@ -144,6 +152,16 @@ public:
 
 private:
   cmGeneratedFileStream(cmGeneratedFileStream const&); // not implemented
+
+  // Compare content held in memory to the destination file and write
+  // it to the temporary file if needed.
+  void ReleaseContentBuffer();
+
+  // Content held in memory for copy-if-different.
+  cmOStringStream* ContentBuffer;
+
+  // Whether the temporary file was opened in binary mode.
+  bool Binary;
 };
 
 #if defined(__sgi) && !defined(__GNUC__)
@@ -39,6 +39,11 @@ public:
    */
   virtual std::string GetName() const { return "get_directory_property";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmGetDirectoryPropertyCommand, cmCommand);
 };
 
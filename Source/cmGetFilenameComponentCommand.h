@@ -48,6 +48,11 @@ public:
    */
   virtual std::string GetName() const { return "get_filename_component";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmGetFilenameComponentCommand, cmCommand);
 };
 
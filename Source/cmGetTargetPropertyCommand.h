@@ -34,6 +34,11 @@ public:
    */
   virtual std::string GetName() const { return "get_target_property";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmGetTargetPropertyCommand, cmCommand);
 };
 
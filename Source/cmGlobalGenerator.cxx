@@ -1116,6 +1116,15 @@ void cmGlobalGenerator::Configure()
       }
     this->CMakeInstance->UpdateProgress(msg.str().c_str(), -1);
     }
+
+  if(this->CMakeInstance->GetDebugOutput())
+    {
+    cmListFileCache* lfc = cmListFileCache::GetInstance();
+    cmOStringStream msg;
+    msg << "   Parsed " << lfc->GetNumberOfParses() << " list files, "
+        << "reused " << lfc->GetNumberOfHits() << " cached parses";
+    cmSystemTools::Message(msg.str().c_str());
+    }
 }
 
 cmExportBuildFileGenerator*
@@ -1173,6 +1182,10 @@ void cmGlobalGenerator::Generate()
     return;
     }
 
+  unsigned long usageHitsStart;
+  unsigned long usageMissesStart;
+  cmTarget::GetUsageRequirementsCacheStats(usageHitsStart, usageMissesStart);
+
   this->FinalizeTargetCompileInfo();
 
 #ifdef CMAKE_BUILD_WITH_CMAKE
@@ -1308,6 +1321,18 @@ void cmGlobalGenerator::Generate()
     this->GetCMakeInstance()->IssueMessage(cmake::AUTHOR_WARNING, w.str());
     }
 
+  if(this->CMakeInstance->GetDebugOutput())
+    {
+    unsigned long usageHits;
+    unsigned long usageMisses;
+    cmTarget::GetUsageRequirementsCacheStats(usageHits, usageMisses);
+    cmOStringStream msg;
+    msg << "   Computed " << (usageMisses - usageMissesStart)
+        << " target usage requirements, reused "
+        << (usageHits - usageHitsStart) << " cached results";
+    cmSystemTools::Message(msg.str().c_str());
+    }
+
   this->CMakeInstance->UpdateProgress("Generating done", -1);
 }
 
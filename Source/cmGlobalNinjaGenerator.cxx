@@ -110,6 +110,83 @@ std::string cmGlobalNinjaGenerator::EncodeDepfileSpace(const std::string &path)
   return result;
 }
 
+// Append EncodeIdent(EncodePath(path), vars) to the given buffer.
+static void AppendEncodedPath(std::string& out, const std::string& path,
+                              std::ostream& vars)
+{
+  // Encode all characters in one pass without temporaries.  A path with
+  // a character that needs a helper variable is rare, so drop what was
+  // appended and start over the slow way.
+  std::string::size_type start = out.size();
+  for(std::string::const_iterator i = path.begin(); i != path.end(); ++i)
+    {
+    char c = *i;
+    if(!IsIdentChar(c))
+      {
+      out.resize(start);
+      out += cmGlobalNinjaGenerator::EncodeIdent(
+        cmGlobalNinjaGenerator::EncodePath(path), vars);
+      return;
+      }
+#ifdef _WIN32
+    if(cmGlobalNinjaGenerator::IsMinGW())
+      {
+      if(c == '\\')
+        {
+        c = '/';
+        }
+      }
+    else if(c == '/')
+      {
+      c = '\\';
+      }
+#endif
+    switch(c)
+      {
+      case '$': out += "$$"; break;
+      case ' ': out += "$ "; break;
+      case ':': out += "$:"; break;
+      default: out += c; break;
+      }
+    }
+}
+
+// Append the variable assignment written by WriteVariable with an
+// indentation of one and no comment to the given buffer.
+static void AppendVariable(std::string& out, const std::string& name,
+                           const std::string& value)
+{
+  if(name.empty())
+    {
+    cmSystemTools::Error("No name given for WriteVariable! called "
+                         "with comment: ", "");
+    return;
+    }
+
+  // Trim whitespace as cmSystemTools::TrimWhitespace does and do not
+  // add a variable if the value is empty.
+  std::string::const_iterator start = value.begin();
+  while(start != value.end() && *start <= ' ')
+    {
+    ++start;
+    }
+  if(start == value.end())
+    {
+    return;
+    }
+  std::string::const_iterator stop = value.end() - 1;
+  while(*stop <= ' ')
+    {
+    --stop;
+    }
+
+  out += cmGlobalNinjaGenerator::INDENT;
+  out += name;
+  out += " = ";
+  out.append(start, stop + 1);
+  out += "\n";
+}
+
 void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
                                         const std::string& comment,
                                         const std::string& rule,
@@ -141,7 +218,27 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
 
   cmGlobalNinjaGenerator::WriteComment(os, comment);
 
-  std::string arguments;
+  // Assemble the whole statement in a buffer that keeps its capacity
+  // from one statement to the next and write it with a single call.
+  // Identifiers that need a helper variable write its definition to
+  // the stream directly, ahead of the statement using it.
+  std::string& build = this->BuildStatement;
+  build.clear();
+
+  // Write outputs files.
+  build += "build";
+  for(cmNinjaDeps::const_iterator i = outputs.begin();
+      i != outputs.end(); ++i)
+    {
+    build += " ";
+    AppendEncodedPath(build, *i, os);
+    this->CombinedBuildOutputs.insert( EncodePath(*i) );
+    }
+  build += ": ";
+
+  // Write the rule.
+  build += rule;
+  std::string::size_type ruleEnd = build.size();
 
   // TODO: Better formatting for when there are multiple input/output files.
 
@@ -150,68 +247,53 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
       i != explicitDeps.end();
       ++i)
     {
-    arguments += " " + EncodeIdent(EncodePath(*i), os);
+    build += " ";
+    AppendEncodedPath(build, *i, os);
     }
 
   // Write implicit dependencies.
   if(!implicitDeps.empty())
     {
-    arguments += " |";
+    build += " |";
     for(cmNinjaDeps::const_iterator i = implicitDeps.begin();
         i != implicitDeps.end();
         ++i)
-      arguments += " " + EncodeIdent(EncodePath(*i), os);
+      {
+      build += " ";
+      AppendEncodedPath(build, *i, os);
+      }
     }
 
   // Write order-only dependencies.
   if(!orderOnlyDeps.empty())
     {
-    arguments += " ||";
+    build += " ||";
     for(cmNinjaDeps::const_iterator i = orderOnlyDeps.begin();
         i != orderOnlyDeps.end();
         ++i)
-      arguments += " " + EncodeIdent(EncodePath(*i), os);
-    }
-
-  arguments += "\n";
-
-  std::string build;
-
-  // Write outputs files.
-  build += "build";
-  for(cmNinjaDeps::const_iterator i = outputs.begin();
-      i != outputs.end(); ++i)
-    {
-    build += " " + EncodeIdent(EncodePath(*i), os);
-    this->CombinedBuildOutputs.insert( EncodePath(*i) );
+      {
+      build += " ";
+      AppendEncodedPath(build, *i, os);
+      }
     }
-  build += ":";
 
-  // Write the rule.
-  build += " " + rule;
+  build += "\n";
 
   // Write the variables bound to this build statement.
-  cmOStringStream variable_assignments;
   for(cmNinjaVars::const_iterator i = variables.begin();
       i != variables.end(); ++i)
-    cmGlobalNinjaGenerator::WriteVariable(variable_assignments,
-                                          i->first, i->second, "", 1);
+    {
+    AppendVariable(build, i->first, i->second);
+    }
 
   // check if a response file rule should be used
-  std::string buildstr = build;
-  std::string assignments = variable_assignments.str();
-  const std::string& args = arguments;
-  if (cmdLineLimit > 0
-      && args.size() + buildstr.size() + assignments.size()
-                                                    > (size_t) cmdLineLimit) {
-    buildstr += "_RSP_FILE";
-    variable_assignments.clear();
-    cmGlobalNinjaGenerator::WriteVariable(variable_assignments,
-                                          "RSP_FILE", rspfile, "", 1);
-    assignments += variable_assignments.str();
-  }
+  if (cmdLineLimit > 0 && build.size() > (size_t) cmdLineLimit)
+    {
+    build.insert(ruleEnd, "_RSP_FILE");
+    AppendVariable(build, "RSP_FILE", rspfile);
+    }
 
-  os << buildstr << args << assignments;
+  os.write(build.data(), static_cast<std::streamsize>(build.size()));
 }
 
 void cmGlobalNinjaGenerator::WritePhonyBuild(std::ostream& os,
@@ -370,6 +370,9 @@ private:
   /// us to detect the set of explicit dependencies that have
   std::set<std::string> CombinedBuildOutputs;
 
+  /// Buffer reused by WriteBuild to assemble each statement.
+  std::string BuildStatement;
+
   /// The mapping from source file to assumed dependencies.
   std::map<std::string, std::set<std::string> > AssumedSourceDependencies;
 
@@ -333,20 +333,22 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
   std::string cache = this->GetCMakeInstance()->GetHomeOutputDirectory();
   cache += "/CMakeCache.txt";
 
-  // Save the list to the cmake file.
+  // Save the list to the cmake file.  The same lists are saved to
+  // the check file read by the check-build-system step.
+  std::vector<std::string> checkDepends;
+  std::vector<std::string> checkOutputs;
+  std::vector<std::string> checkProducts;
+  checkDepends.push_back(lg->Convert(cache, cmLocalGenerator::START_OUTPUT));
   cmakefileStream
     << "# The top level Makefile was generated from the following files:\n"
     << "set(CMAKE_MAKEFILE_DEPENDS\n"
-    << "  \""
-    << lg->Convert(cache,
-                   cmLocalGenerator::START_OUTPUT) << "\"\n";
+    << "  \"" << checkDepends.back() << "\"\n";
   for(std::vector<std::string>::const_iterator i = lfiles.begin();
       i !=  lfiles.end(); ++i)
     {
+    checkDepends.push_back(lg->Convert(*i, cmLocalGenerator::START_OUTPUT));
     cmakefileStream
-      << "  \""
-      << lg->Convert(*i, cmLocalGenerator::START_OUTPUT)
-      << "\"\n";
+      << "  \"" << checkDepends.back() << "\"\n";
     }
   cmakefileStream
     << "  )\n\n";
@@ -357,15 +359,14 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
   check += "/cmake.check_cache";
 
   // Set the corresponding makefile in the cmake file.
+  checkOutputs.push_back(lg->Convert(makefileName,
+                                     cmLocalGenerator::START_OUTPUT));
+  checkOutputs.push_back(lg->Convert(check, cmLocalGenerator::START_OUTPUT));
   cmakefileStream
     << "# The corresponding makefile is:\n"
     << "set(CMAKE_MAKEFILE_OUTPUTS\n"
-    << "  \""
-    << lg->Convert(makefileName,
-                   cmLocalGenerator::START_OUTPUT) << "\"\n"
-    << "  \""
-    << lg->Convert(check,
-                   cmLocalGenerator::START_OUTPUT) << "\"\n";
+    << "  \"" << checkOutputs[0] << "\"\n"
+    << "  \"" << checkOutputs[1] << "\"\n";
   cmakefileStream << "  )\n\n";
 
   // CMake must rerun if a byproduct is missing.
@@ -378,9 +379,8 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
   for(std::vector<std::string>::const_iterator k = outfiles.begin();
       k != outfiles.end(); ++k)
     {
-    cmakefileStream << "  \"" <<
-      lg->Convert(*k,cmLocalGenerator::HOME_OUTPUT)
-                    << "\"\n";
+    checkProducts.push_back(lg->Convert(*k,cmLocalGenerator::HOME_OUTPUT));
+    cmakefileStream << "  \"" << checkProducts.back() << "\"\n";
     }
 
   // add in all the directory information files
@@ -392,15 +392,46 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
     tmpStr = lg->GetMakefile()->GetStartOutputDirectory();
     tmpStr += cmake::GetCMakeFilesDirectory();
     tmpStr += "/CMakeDirectoryInformation.cmake";
-    cmakefileStream << "  \"" <<
-      lg->Convert(tmpStr,cmLocalGenerator::HOME_OUTPUT)
-                    << "\"\n";
+    checkProducts.push_back(lg->Convert(tmpStr,cmLocalGenerator::HOME_OUTPUT));
+    cmakefileStream << "  \"" << checkProducts.back() << "\"\n";
     }
   cmakefileStream << "  )\n\n";
   }
 
   this->WriteMainCMakefileLanguageRules(cmakefileStream,
                                         this->LocalGenerators);
+
+  // Finish the cmake file before the check file so that the check
+  // file is never older than the cmake file.
+  cmakefileStream.Close();
+
+  // Save the same lists in a plain form.  The check-build-system step
+  // reads this file instead of running the cmake file through the
+  // CMake language interpreter on every invocation of make.
+  std::string checkName = cmakefileName;
+  checkName += ".check";
+  cmGeneratedFileStream checkStream(checkName.c_str());
+  if(!checkStream)
+    {
+    return;
+    }
+  lg->WriteDisclaimer(checkStream);
+  checkStream
+    << "# Byproducts (P), dependencies (D) and outputs (O) of the\n"
+    << "# generate step, checked by the check-build-system step.\n";
+  std::vector<std::string>::const_iterator ci;
+  for(ci = checkProducts.begin(); ci != checkProducts.end(); ++ci)
+    {
+    checkStream << "P " << *ci << "\n";
+    }
+  for(ci = checkDepends.begin(); ci != checkDepends.end(); ++ci)
+    {
+    checkStream << "D " << *ci << "\n";
+    }
+  for(ci = checkOutputs.begin(); ci != checkOutputs.end(); ++ci)
+    {
+    checkStream << "O " << *ci << "\n";
+    }
 }
 
 void cmGlobalUnixMakefileGenerator3
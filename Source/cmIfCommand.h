@@ -65,6 +65,11 @@ public:
    */
   virtual std::string GetName() const { return "if";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   /**
    * This determines if the command is invoked when in script mode.
    */
@@ -46,6 +46,11 @@ public:
    */
   virtual std::string GetName() const { return "list";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmListCommand, cmCommand);
 protected:
   bool HandleLengthCommand(std::vector<std::string> const& args);
@@ -18,6 +18,11 @@
 #include "cmVersion.h"
 
 #include <cmsys/RegularExpression.hxx>
+#include <cmsys/FStream.hxx>
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include "cmCryptoHash.h"
+#endif
 
 #ifdef __BORLANDC__
 # pragma warn -8060 /* possibly incorrect assignment */
@@ -37,6 +42,7 @@ struct cmListFileParser
   const char* FileName;
   cmListFileLexer* Lexer;
   cmListFileFunction Function;
+  bool IssuedMessage;
   enum { SeparationOkay, SeparationWarning, SeparationError} Separation;
 };
 
@@ -44,7 +50,7 @@ struct cmListFileParser
 cmListFileParser::cmListFileParser(cmListFile* lf, cmMakefile* mf,
                                    const char* filename):
   ListFile(lf), Makefile(mf), FileName(filename),
-  Lexer(cmListFileLexer_New())
+  Lexer(cmListFileLexer_New()), IssuedMessage(false)
 {
 }
 
@@ -151,10 +157,21 @@ bool cmListFile::ParseFile(const char* filename,
   bool parseError = false;
   this->ModifiedTime = cmSystemTools::ModifiedTime(filename);
 
-  {
-  cmListFileParser parser(this, mf, filename);
-  parseError = !parser.ParseFile();
-  }
+  // Reuse the functions parsed by an earlier read of the same file.
+  cmListFileCache* cache = cmListFileCache::GetInstance();
+  if(!cache->Lookup(filename, this->Functions))
+    {
+    cache->CountParse();
+    cmListFileParser parser(this, mf, filename);
+    parseError = !parser.ParseFile();
+
+    // Files that produce diagnostics are not cached so that every
+    // read reports them in its own context.
+    if(!parseError && !parser.IssuedMessage)
+      {
+      cache->Store(filename, this->Functions);
+      }
+    }
 
   if(parseError)
     {
@@ -397,6 +414,7 @@ bool cmListFileParser::AddArgument(cmListFileLexer_Token* token,
     << "  " << this->FileName << ":" << token->line << ":"
     << token->column << "\n"
     << "Argument not separated from preceding token by whitespace.";
+  this->IssuedMessage = true;
   if(isError)
     {
     this->Makefile->IssueMessage(cmake::FATAL_ERROR, m.str());
@@ -409,6 +427,332 @@ bool cmListFileParser::AddArgument(cmListFileLexer_Token* token,
     }
 }
 
+//----------------------------------------------------------------------------
+cmListFileCache* cmListFileCache::GetInstance()
+{
+  static cmListFileCache instance;
+  return &instance;
+}
+
+//----------------------------------------------------------------------------
+std::string cmListFileCache::HashFile(const char* path)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmCryptoHashMD5 md5;
+  return md5.HashFile(path);
+#else
+  (void)path;
+  return "";
+#endif
+}
+
+//----------------------------------------------------------------------------
+void cmListFileCache::SetFilePath(EntryMap::iterator i)
+{
+  // Entries are never removed so the key may be referenced by the
+  // FilePath of the cached arguments for the life of the process.
+  const char* filePath = i->first.c_str();
+  std::vector<cmListFileFunction>& functions = i->second.Functions;
+  for(std::vector<cmListFileFunction>::iterator fi = functions.begin();
+      fi != functions.end(); ++fi)
+    {
+    fi->FilePath = i->first;
+    for(std::vector<cmListFileArgument>::iterator ai =
+          fi->Arguments.begin(); ai != fi->Arguments.end(); ++ai)
+      {
+      ai->FilePath = filePath;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileCache::Lookup(const char* path,
+                             std::vector<cmListFileFunction>& functions)
+{
+  EntryMap::iterator i = this->Entries.find(path);
+  if(i == this->Entries.end())
+    {
+    return false;
+    }
+  Entry& e = i->second;
+  cmFileStamp stamp;
+  bool stable = false;
+  if(!stamp.Load(path, stable))
+    {
+    return false;
+    }
+  if(!(stable && e.HasStamp && stamp == e.FileStamp))
+    {
+    // The stamp cannot prove the file unchanged.  Compare the content
+    // hash instead, if we have one.
+    if(e.Hash.empty() || HashFile(path) != e.Hash)
+      {
+      return false;
+      }
+    e.FileStamp = stamp;
+    e.HasStamp = stable;
+    }
+  e.Used = true;
+  functions = e.Functions;
+  ++this->Hits;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmListFileCache::Store(const char* path,
+                            std::vector<cmListFileFunction> const& functions)
+{
+  cmFileStamp stamp;
+  bool stable = false;
+  if(!stamp.Load(path, stable))
+    {
+    return;
+    }
+  std::string hash = HashFile(path);
+  if(!stable && hash.empty())
+    {
+    // Nothing can validate this entry later.
+    return;
+    }
+
+  EntryMap::iterator i =
+    this->Entries.insert(EntryMap::value_type(path, Entry())).first;
+  Entry& e = i->second;
+  e.FileStamp = stamp;
+  e.HasStamp = stable;
+  e.Used = true;
+  e.Hash = hash;
+  e.Functions = functions;
+  SetFilePath(i);
+}
+
+//----------------------------------------------------------------------------
+// The saved cache file is a sequence of records in a compact binary
+// form.  Integers are stored as 4 bytes in little-endian order and
+// strings as their length followed by their characters:
+//
+//   "CMLFC1" <cmake-version> <num-files>
+//   for each file:    <path> <md5> <num-functions>
+//   for each function: <name> <line> <num-arguments>
+//   for each argument: <delimiter:1 byte> <line> <value>
+namespace
+{
+  class cmListFileCacheWriter
+  {
+  public:
+    cmListFileCacheWriter(std::string& buf): Buffer(buf) {}
+    void Int(unsigned long v)
+      {
+      for(int i=0; i < 4; ++i)
+        {
+        this->Buffer += static_cast<char>((v >> (8*i)) & 0xff);
+        }
+      }
+    void String(std::string const& s)
+      {
+      this->Int(static_cast<unsigned long>(s.size()));
+      this->Buffer += s;
+      }
+    std::string& Buffer;
+  };
+
+  class cmListFileCacheReader
+  {
+  public:
+    cmListFileCacheReader(std::string const& buf):
+      Buffer(buf), Pos(0) {}
+    bool Int(unsigned long& v)
+      {
+      if(this->Buffer.size() - this->Pos < 4)
+        {
+        return false;
+        }
+      v = 0;
+      for(int i=0; i < 4; ++i)
+        {
+        unsigned char c =
+          static_cast<unsigned char>(this->Buffer[this->Pos++]);
+        v |= static_cast<unsigned long>(c) << (8*i);
+        }
+      return true;
+      }
+    bool String(std::string& s)
+      {
+      unsigned long n;
+      if(!this->Int(n) || this->Buffer.size() - this->Pos < n)
+        {
+        return false;
+        }
+      s.assign(this->Buffer, this->Pos, n);
+      this->Pos += n;
+      return true;
+      }
+    bool Byte(unsigned char& c)
+      {
+      if(this->Pos >= this->Buffer.size())
+        {
+        return false;
+        }
+      c = static_cast<unsigned char>(this->Buffer[this->Pos++]);
+      return true;
+      }
+    std::string const& Buffer;
+    std::string::size_type Pos;
+  };
+}
+
+static const char cmListFileCacheMagic[] = "CMLFC1";
+
+//----------------------------------------------------------------------------
+bool cmListFileCache::Load(const std::string& fname)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmsys::ifstream fin(fname.c_str(), std::ios::in | std::ios::binary);
+  if(!fin)
+    {
+    return false;
+    }
+  std::string buf((std::istreambuf_iterator<char>(fin)),
+                  std::istreambuf_iterator<char>());
+  cmListFileCacheReader r(buf);
+
+  std::string magic;
+  std::string version;
+  unsigned long numFiles;
+  if(!r.String(magic) || magic != cmListFileCacheMagic ||
+     !r.String(version) || version != cmVersion::GetCMakeVersion() ||
+     !r.Int(numFiles))
+    {
+    return false;
+    }
+
+  // Decode everything before touching the cache so that a truncated
+  // file is ignored as a whole.
+  typedef std::vector<std::pair<std::string, Entry> > LoadedType;
+  LoadedType loaded;
+  for(unsigned long fi = 0; fi < numFiles; ++fi)
+    {
+    loaded.push_back(LoadedType::value_type());
+    std::string& path = loaded.back().first;
+    Entry& e = loaded.back().second;
+    unsigned long numFunctions;
+    if(!r.String(path) || !r.String(e.Hash) || !r.Int(numFunctions))
+      {
+      return false;
+      }
+    for(unsigned long i = 0; i < numFunctions; ++i)
+      {
+      e.Functions.push_back(cmListFileFunction());
+      cmListFileFunction& f = e.Functions.back();
+      unsigned long line;
+      unsigned long numArguments;
+      if(!r.String(f.Name) || !r.Int(line) || !r.Int(numArguments))
+        {
+        return false;
+        }
+      f.Line = static_cast<long>(line);
+      for(unsigned long j = 0; j < numArguments; ++j)
+        {
+        f.Arguments.push_back(cmListFileArgument());
+        cmListFileArgument& a = f.Arguments.back();
+        unsigned char delim;
+        if(!r.Byte(delim) || delim > cmListFileArgument::Bracket ||
+           !r.Int(line) || !r.String(a.Value))
+          {
+          return false;
+          }
+        a.Delim = static_cast<cmListFileArgument::Delimiter>(delim);
+        a.Line = static_cast<long>(line);
+        }
+      }
+    }
+
+  for(LoadedType::iterator li = loaded.begin(); li != loaded.end(); ++li)
+    {
+    // Keep entries already known to this process.
+    std::pair<EntryMap::iterator, bool> ins =
+      this->Entries.insert(EntryMap::value_type(li->first, Entry()));
+    if(ins.second)
+      {
+      ins.first->second.Hash = li->second.Hash;
+      ins.first->second.Functions.swap(li->second.Functions);
+      SetFilePath(ins.first);
+      }
+    }
+  return true;
+#else
+  (void)fname;
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileCache::Save(const std::string& fname)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  std::string buf;
+  cmListFileCacheWriter w(buf);
+  unsigned long numFiles = 0;
+  for(EntryMap::const_iterator i = this->Entries.begin();
+      i != this->Entries.end(); ++i)
+    {
+    if(i->second.Used && !i->second.Hash.empty())
+      {
+      ++numFiles;
+      }
+    }
+  w.String(cmListFileCacheMagic);
+  w.String(cmVersion::GetCMakeVersion());
+  w.Int(numFiles);
+  for(EntryMap::const_iterator i = this->Entries.begin();
+      i != this->Entries.end(); ++i)
+    {
+    Entry const& e = i->second;
+    if(!e.Used || e.Hash.empty())
+      {
+      continue;
+      }
+    w.String(i->first);
+    w.String(e.Hash);
+    w.Int(static_cast<unsigned long>(e.Functions.size()));
+    for(std::vector<cmListFileFunction>::const_iterator fi =
+          e.Functions.begin(); fi != e.Functions.end(); ++fi)
+      {
+      w.String(fi->Name);
+      w.Int(static_cast<unsigned long>(fi->Line));
+      w.Int(static_cast<unsigned long>(fi->Arguments.size()));
+      for(std::vector<cmListFileArgument>::const_iterator ai =
+            fi->Arguments.begin(); ai != fi->Arguments.end(); ++ai)
+        {
+        w.Buffer += static_cast<char>(ai->Delim);
+        w.Int(static_cast<unsigned long>(ai->Line));
+        w.String(ai->Value);
+        }
+      }
+    }
+
+  // Write a temporary file and rename it into place so that a
+  // concurrent or interrupted run never sees a partial file.
+  std::string tmp = fname + ".tmp";
+  {
+  cmsys::ofstream fout(tmp.c_str(), std::ios::out | std::ios::binary);
+  if(!fout)
+    {
+    return false;
+    }
+  fout.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+  if(!fout)
+    {
+    return false;
+    }
+  }
+  return cmSystemTools::RenameFile(tmp.c_str(), fname.c_str());
+#else
+  (void)fname;
+  return false;
+#endif
+}
+
 //----------------------------------------------------------------------------
 void cmListFileBacktrace::MakeRelative()
 {
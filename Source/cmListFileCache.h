@@ -13,17 +13,12 @@
 #define cmListFileCache_h
 
 #include "cmStandardIncludes.h"
+#include "cmFileStamp.h"
 
+class cmCommand;
 class cmLocalGenerator;
-
-/** \class cmListFileCache
- * \brief A class to cache list file contents.
- *
- * cmListFileCache is a class used to cache the contents of parsed
- * cmake list files.
- */
-
 class cmMakefile;
+class cmake;
 
 struct cmListFileArgument
 {
@@ -65,7 +60,16 @@ std::ostream& operator<<(std::ostream&, cmListFileContext const&);
 
 struct cmListFileFunction: public cmListFileContext
 {
+  cmListFileFunction(): Command(0), CommandGeneration(0) {}
   std::vector<cmListFileArgument> Arguments;
+
+  // The command prototype this call resolved to when last invoked,
+  // the name it was resolved from since callers may reuse an instance,
+  // and the commands generation of the cmake instance that resolved it.
+  // See cmake::GetCommand(cmListFileFunction const&).
+  mutable cmCommand* Command;
+  mutable std::string CommandName;
+  mutable unsigned long CommandGeneration;
 };
 
 class cmListFileBacktrace: public std::vector<cmListFileContext>
@@ -97,6 +101,69 @@ struct cmListFile
   std::vector<cmListFileFunction> Functions;
 };
 
+/** \class cmListFileCache
+ * \brief A class to cache list file contents.
+ *
+ * cmListFileCache is a process-wide cache of the contents of parsed
+ * cmake list files.  Modules that are included many times during
+ * configuration (and by every try_compile project) are lexed only
+ * once as long as their modification time and size do not change.
+ */
+class cmListFileCache
+{
+public:
+  /** Get the cache instance shared by every cmMakefile.  */
+  static cmListFileCache* GetInstance();
+
+  /**
+   * Look up the parsed functions of the given file.  Returns false if
+   * the file has never been stored or changed on disk since then.
+   */
+  bool Lookup(const char* path, std::vector<cmListFileFunction>& functions);
+
+  /** Store the parsed functions of the given file.  */
+  void Store(const char* path,
+             std::vector<cmListFileFunction> const& functions);
+
+  /**
+   * Load entries saved by a previous run.  They are validated against
+   * the content hash of each file before use.
+   */
+  bool Load(const std::string& fname);
+
+  /** Save the entries used by this process for a later run.  */
+  bool Save(const std::string& fname);
+
+  /** Number of times a file was lexed and parsed.  */
+  unsigned long GetNumberOfParses() const { return this->Parses; }
+
+  /** Number of times a parse was avoided by reusing the cache.  */
+  unsigned long GetNumberOfHits() const { return this->Hits; }
+
+  /** Record that a file had to be lexed and parsed.  */
+  void CountParse() { ++this->Parses; }
+
+private:
+  cmListFileCache(): Parses(0), Hits(0) {}
+
+  struct Entry
+  {
+    Entry(): HasStamp(false), Used(false) {}
+    cmFileStamp FileStamp;
+    bool HasStamp;
+    bool Used;
+    std::string Hash;
+    std::vector<cmListFileFunction> Functions;
+  };
+  typedef std::map<std::string, Entry> EntryMap;
+  EntryMap Entries;
+  unsigned long Parses;
+  unsigned long Hits;
+
+  static std::string HashFile(const char* path);
+  static void SetFilePath(EntryMap::iterator i);
+};
+
 struct cmValueWithOrigin {
   cmValueWithOrigin(const std::string &value,
                           const cmListFileBacktrace &bt)
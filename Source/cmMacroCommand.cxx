@@ -13,14 +13,435 @@
 
 #include "cmake.h"
 
+//----------------------------------------------------------------------------
+// A reference to a macro argument found in the recorded body.
+struct cmMacroSlot
+{
+  enum SlotType { Literal, Formal, ArgC, ArgN, ArgV, ArgVN };
+  SlotType Type;
+  unsigned int Index;
+
+  // The literal text, or the original reference for ARGV<n> in case
+  // fewer arguments are given.
+  std::string Text;
+};
+
+// A recorded argument pre-processed into literal text and slots.
+struct cmMacroArgumentForm
+{
+  std::vector<cmMacroSlot> Slots;
+
+  // Whether the argument has no slots and is used as recorded.
+  bool Verbatim;
+
+  // Whether literal text contains a '$' that may combine with
+  // substituted values into another argument reference.
+  bool Recheck;
+};
+
+//----------------------------------------------------------------------------
+// The recorded body of a macro.  It is pre-processed once when the
+// macro is defined and then shared by the prototype command and all
+// clones made to invoke it.
+class cmMacroBody
+{
+public:
+  cmMacroBody(): Compiled(false), ReferenceCount(1) {}
+
+  void Register() { ++this->ReferenceCount; }
+  void UnRegister()
+    {
+    if(--this->ReferenceCount == 0)
+      {
+      delete this;
+      }
+    }
+
+  void Compile();
+  bool FindSlot(std::string const& text, std::string::size_type& pos,
+                std::string::size_type& end, cmMacroSlot& slot,
+                unsigned int const* argc) const;
+
+  std::vector<std::string> Args;
+  std::vector<cmListFileFunction> Functions;
+  std::vector<std::vector<cmMacroArgumentForm> > Forms;
+  cmPolicies::PolicyMap Policies;
+  std::string FilePath;
+
+  // Whether the formal argument names allow the slot form.  Otherwise
+  // every invocation substitutes the references textually.
+  bool Compiled;
+private:
+  unsigned int ReferenceCount;
+};
+
+//----------------------------------------------------------------------------
+void cmMacroBody::Compile()
+{
+  if(!this->Functions.empty())
+    {
+    this->FilePath = this->Functions[0].FilePath;
+    }
+
+  // Set the FilePath on the arguments to match the macro since it is
+  // not stored and the original values may be freed.
+  for(std::vector<cmListFileFunction>::iterator fi = this->Functions.begin();
+      fi != this->Functions.end(); ++fi)
+    {
+    for(std::vector<cmListFileArgument>::iterator ai = fi->Arguments.begin();
+        ai != fi->Arguments.end(); ++ai)
+      {
+      ai->FilePath = this->FilePath.c_str();
+      }
+    }
+
+  // A reference to a formal argument is recognized by scanning to the
+  // first '}', so names that could overlap other references are left
+  // to textual substitution.
+  for(unsigned int j = 1; j < this->Args.size(); ++j)
+    {
+    if(this->Args[j].empty() ||
+       this->Args[j].find_first_of("${}") != std::string::npos)
+      {
+      return;
+      }
+    }
+  this->Compiled = true;
+
+  this->Forms.resize(this->Functions.size());
+  for(unsigned int c = 0; c < this->Functions.size(); ++c)
+    {
+    std::vector<cmListFileArgument> const& args =
+      this->Functions[c].Arguments;
+    std::vector<cmMacroArgumentForm>& forms = this->Forms[c];
+    forms.resize(args.size());
+    for(unsigned int k = 0; k < args.size(); ++k)
+      {
+      cmMacroArgumentForm& form = forms[k];
+      std::string const& value = args[k].Value;
+      form.Verbatim = true;
+      form.Recheck = false;
+      if(args[k].Delim == cmListFileArgument::Bracket)
+        {
+        continue;
+        }
+      std::string::size_type last = 0;
+      std::string::size_type pos = 0;
+      std::string::size_type end = 0;
+      cmMacroSlot slot;
+      while(this->FindSlot(value, pos, end, slot, 0))
+        {
+        if(pos > last)
+          {
+          cmMacroSlot text;
+          text.Type = cmMacroSlot::Literal;
+          text.Index = 0;
+          text.Text = value.substr(last, pos - last);
+          form.Recheck = form.Recheck ||
+            text.Text.find('$') != std::string::npos;
+          form.Slots.push_back(text);
+          }
+        form.Slots.push_back(slot);
+        form.Verbatim = false;
+        last = pos = end;
+        }
+      if(form.Verbatim)
+        {
+        form.Slots.clear();
+        continue;
+        }
+      if(last < value.size())
+        {
+        cmMacroSlot text;
+        text.Type = cmMacroSlot::Literal;
+        text.Index = 0;
+        text.Text = value.substr(last);
+        form.Recheck = form.Recheck ||
+          text.Text.find('$') != std::string::npos;
+        form.Slots.push_back(text);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmMacroBody::FindSlot(std::string const& text,
+                           std::string::size_type& pos,
+                           std::string::size_type& end,
+                           cmMacroSlot& slot,
+                           unsigned int const* argc) const
+{
+  // Find the next "${name}" whose name is a formal argument, ARGC,
+  // ARGN, ARGV or ARGV<n>.  Formal arguments take precedence as they
+  // are substituted first.  If argc is given only the ARGV<n>
+  // references substituted for that many arguments are found.
+  while((pos = text.find("${", pos)) != std::string::npos)
+    {
+    std::string::size_type close = text.find('}', pos + 2);
+    if(close == std::string::npos)
+      {
+      return false;
+      }
+    std::string::size_type nameLen = close - pos - 2;
+    char const* name = text.c_str() + pos + 2;
+    end = close + 1;
+    slot.Type = cmMacroSlot::Literal;
+    for(unsigned int j = 1; j < this->Args.size(); ++j)
+      {
+      if(this->Args[j].size() == nameLen &&
+         this->Args[j].compare(0, nameLen, name, nameLen) == 0)
+        {
+        slot.Type = cmMacroSlot::Formal;
+        slot.Index = j - 1;
+        break;
+        }
+      }
+    if(slot.Type == cmMacroSlot::Literal &&
+       nameLen >= 4 && strncmp(name, "ARG", 3) == 0)
+      {
+      if(nameLen == 4 && name[3] == 'C')
+        {
+        slot.Type = cmMacroSlot::ArgC;
+        }
+      else if(nameLen == 4 && name[3] == 'N')
+        {
+        slot.Type = cmMacroSlot::ArgN;
+        }
+      else if(name[3] == 'V')
+        {
+        if(nameLen == 4)
+          {
+          slot.Type = cmMacroSlot::ArgV;
+          }
+        else if(nameLen <= 13 && isdigit(name[4]) &&
+                (name[4] != '0' || nameLen == 5))
+          {
+          // Only the canonical spelling of a number is substituted.
+          unsigned long n = 0;
+          std::string::size_type i = 4;
+          for(; i < nameLen && isdigit(name[i]); ++i)
+            {
+            n = n * 10 + static_cast<unsigned long>(name[i] - '0');
+            }
+          if(i == nameLen && (!argc || n < *argc))
+            {
+            slot.Type = cmMacroSlot::ArgVN;
+            slot.Index = static_cast<unsigned int>(n);
+            }
+          }
+        }
+      }
+    if(slot.Type != cmMacroSlot::Literal)
+      {
+      slot.Text = text.substr(pos, end - pos);
+      return true;
+      }
+    ++pos;
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+// The values bound to the argument slots by one macro invocation.
+class cmMacroInvocation
+{
+public:
+  cmMacroInvocation(cmMacroBody const* body,
+                    std::vector<std::string> const& args):
+    Body(body), Values(args), ArgNInitialized(false), ArgVInitialized(false)
+    {
+    char buf[32];
+    sprintf(buf, "%u", static_cast<unsigned int>(args.size()));
+    this->ArgC = buf;
+    this->ValuesHaveDollar = false;
+    for(std::vector<std::string>::const_iterator i = args.begin();
+        i != args.end(); ++i)
+      {
+      if(i->find('$') != std::string::npos)
+        {
+        this->ValuesHaveDollar = true;
+        break;
+        }
+      }
+    }
+
+  void Substitute(cmListFileArgument const& karg,
+                  cmMacroArgumentForm const* form, std::string& out);
+private:
+  void SubstituteText(std::string& tmps);
+  std::string const& GetArgN();
+  std::string const& GetArgV();
+
+  cmMacroBody const* Body;
+  std::vector<std::string> const& Values;
+  std::string ArgC;
+  std::string ArgN;
+  std::string ArgV;
+  bool ArgNInitialized;
+  bool ArgVInitialized;
+  bool ValuesHaveDollar;
+};
+
+//----------------------------------------------------------------------------
+std::string const& cmMacroInvocation::GetArgN()
+{
+  if(!this->ArgNInitialized)
+    {
+    std::vector<std::string>::const_iterator eit;
+    std::vector<std::string>::size_type cnt = 0;
+    for(eit = this->Values.begin(); eit != this->Values.end(); ++eit)
+      {
+      if ( cnt >= this->Body->Args.size()-1 )
+        {
+        if ( this->ArgN.size() > 0 )
+          {
+          this->ArgN += ";";
+          }
+        this->ArgN += *eit;
+        }
+      cnt ++;
+      }
+    this->ArgNInitialized = true;
+    }
+  return this->ArgN;
+}
+
+//----------------------------------------------------------------------------
+std::string const& cmMacroInvocation::GetArgV()
+{
+  if(!this->ArgVInitialized)
+    {
+    std::vector<std::string>::const_iterator eit;
+    for(eit = this->Values.begin(); eit != this->Values.end(); ++eit)
+      {
+      if ( this->ArgV.size() > 0 )
+        {
+        this->ArgV += ";";
+        }
+      this->ArgV += *eit;
+      }
+    this->ArgVInitialized = true;
+    }
+  return this->ArgV;
+}
+
+//----------------------------------------------------------------------------
+void cmMacroInvocation::Substitute(cmListFileArgument const& karg,
+                                   cmMacroArgumentForm const* form,
+                                   std::string& out)
+{
+  if(karg.Delim == cmListFileArgument::Bracket || (form && form->Verbatim))
+    {
+    out = karg.Value;
+    return;
+    }
+  if(!form)
+    {
+    out = karg.Value;
+    this->SubstituteText(out);
+    return;
+    }
+
+  // Bind the slots in a single pass.
+  out.clear();
+  for(std::vector<cmMacroSlot>::const_iterator si = form->Slots.begin();
+      si != form->Slots.end(); ++si)
+    {
+    switch(si->Type)
+      {
+      case cmMacroSlot::Literal: out += si->Text; break;
+      case cmMacroSlot::Formal: out += this->Values[si->Index]; break;
+      case cmMacroSlot::ArgC: out += this->ArgC; break;
+      case cmMacroSlot::ArgN: out += this->GetArgN(); break;
+      case cmMacroSlot::ArgV: out += this->GetArgV(); break;
+      case cmMacroSlot::ArgVN:
+        if(si->Index < this->Values.size())
+          {
+          out += this->Values[si->Index];
+          }
+        else
+          {
+          out += si->Text;
+          }
+        break;
+      }
+    }
+
+  // Textual substitution replaces one kind of reference after another
+  // so a value may combine with the surrounding text into a reference
+  // replaced later.  Fall back to it if the result has such a reference.
+  if(form->Recheck || this->ValuesHaveDollar)
+    {
+    std::string::size_type pos = 0;
+    std::string::size_type end = 0;
+    cmMacroSlot slot;
+    unsigned int argc = static_cast<unsigned int>(this->Values.size());
+    if(this->Body->FindSlot(out, pos, end, slot, &argc))
+      {
+      out = karg.Value;
+      this->SubstituteText(out);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmMacroInvocation::SubstituteText(std::string& tmps)
+{
+  std::string variable;
+  std::vector<std::string> const& formal = this->Body->Args;
+
+  // replace formal arguments
+  for (unsigned int j = 1; j < formal.size(); ++j)
+    {
+    variable = "${";
+    variable += formal[j];
+    variable += "}";
+    cmSystemTools::ReplaceString(tmps, variable.c_str(),
+                                 this->Values[j-1].c_str());
+    }
+  // replace argc
+  cmSystemTools::ReplaceString(tmps, "${ARGC}", this->ArgC.c_str());
+
+  // repleace ARGN
+  if (tmps.find("${ARGN}") != std::string::npos)
+    {
+    cmSystemTools::ReplaceString(tmps, "${ARGN}", this->GetArgN().c_str());
+    }
+
+  // if the current argument of the current function has ${ARGV in it
+  // then try replacing ARGV values
+  if (tmps.find("${ARGV") != std::string::npos)
+    {
+    char argvName[60];
+
+    // repleace ARGV, compute it only once
+    cmSystemTools::ReplaceString(tmps, "${ARGV}", this->GetArgV().c_str());
+
+    // also replace the ARGV1 ARGV2 ... etc
+    for (unsigned int t = 0; t < this->Values.size(); ++t)
+      {
+      sprintf(argvName,"${ARGV%i}",t);
+      cmSystemTools::ReplaceString(tmps, argvName,
+                                   this->Values[t].c_str());
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
 // define the class for macro commands
 class cmMacroHelperCommand : public cmCommand
 {
 public:
-  cmMacroHelperCommand() {}
+  cmMacroHelperCommand(cmMacroBody* body): Body(body)
+    {
+    this->Body->Register();
+    }
 
   ///! clean up any memory allocated by the macro
-  ~cmMacroHelperCommand() {}
+  ~cmMacroHelperCommand()
+    {
+    this->Body->UnRegister();
+    }
 
   /**
    * This is used to avoid including this command
@@ -34,17 +455,13 @@ public:
     }
 
   /**
-   * This is a virtual constructor for the command.
+   * This is a virtual constructor for the command.  The clone shares
+   * the recorded body, which outlives the prototype if the macro is
+   * redefined while it runs.
    */
   virtual cmCommand* Clone()
   {
-    cmMacroHelperCommand *newC = new cmMacroHelperCommand;
-    // we must copy when we clone
-    newC->Args = this->Args;
-    newC->Functions = this->Functions;
-    newC->FilePath = this->FilePath;
-    newC->Policies = this->Policies;
-    return newC;
+    return new cmMacroHelperCommand(this->Body);
   }
 
   /**
@@ -65,14 +482,12 @@ public:
   /**
    * The name of the command as specified in CMakeList.txt.
    */
-  virtual std::string GetName() const { return this->Args[0]; }
+  virtual std::string GetName() const { return this->Body->Args[0]; }
 
   cmTypeMacro(cmMacroHelperCommand, cmCommand);
 
-  std::vector<std::string> Args;
-  std::vector<cmListFileFunction> Functions;
-  cmPolicies::PolicyMap Policies;
-  std::string FilePath;
+private:
+  cmMacroBody* Body;
 };
 
 
@@ -84,17 +499,15 @@ bool cmMacroHelperCommand::InvokeInitialPass
   std::vector<std::string> expandedArgs;
   this->Makefile->ExpandArguments(args, expandedArgs);
 
-  std::string tmps;
-  cmListFileArgument arg;
-  std::string variable;
+  cmMacroBody const* body = this->Body;
 
   // make sure the number of arguments passed is at least the number
   // required by the signature
-  if (expandedArgs.size() < this->Args.size() - 1)
+  if (expandedArgs.size() < body->Args.size() - 1)
     {
     std::string errorMsg =
       "Macro invoked with incorrect arguments for macro named: ";
-    errorMsg += this->Args[0];
+    errorMsg += body->Args[0];
     this->SetError(errorMsg);
     return false;
     }
@@ -104,122 +517,35 @@ bool cmMacroHelperCommand::InvokeInitialPass
 
   // Push a weak policy scope which restores the policies recorded at
   // macro creation.
-  cmMakefile::PolicyPushPop polScope(this->Makefile, true, this->Policies);
-
-  // set the value of argc
-  cmOStringStream argcDefStream;
-  argcDefStream << expandedArgs.size();
-  std::string argcDef = argcDefStream.str();
-
-  // declare varuiables for ARGV ARGN but do not compute until needed
-  std::string argvDef;
-  std::string argnDef;
-  bool argnDefInitialized = false;
-  bool argvDefInitialized = false;
-  if( this->Functions.size())
-    {
-    this->FilePath = this->Functions[0].FilePath;
-    }
+  cmMakefile::PolicyPushPop polScope(this->Makefile, true, body->Policies);
+
+  // Bind the arguments to the slots of the recorded body.
+  cmMacroInvocation invocation(body, expandedArgs);
+
   // Invoke all the functions that were collected in the block.
   cmListFileFunction newLFF;
   // for each function
-  for(unsigned int c = 0; c < this->Functions.size(); ++c)
+  for(unsigned int c = 0; c < body->Functions.size(); ++c)
     {
+    cmListFileFunction const& func = body->Functions[c];
+
     // Replace the formal arguments and then invoke the command.
-    newLFF.Arguments.clear();
-    newLFF.Arguments.reserve(this->Functions[c].Arguments.size());
-    newLFF.Name = this->Functions[c].Name;
-    newLFF.FilePath = this->Functions[c].FilePath;
-    newLFF.Line = this->Functions[c].Line;
+    newLFF.Arguments.resize(func.Arguments.size());
+    newLFF.Name = func.Name;
+    newLFF.FilePath = func.FilePath;
+    newLFF.Line = func.Line;
 
     // for each argument of the current function
-    for (std::vector<cmListFileArgument>::iterator k =
-           this->Functions[c].Arguments.begin();
-         k != this->Functions[c].Arguments.end(); ++k)
+    for (unsigned int k = 0; k < func.Arguments.size(); ++k)
       {
-      // Set the FilePath on the arguments to match the function since it is
-      // not stored and the original values may be freed
-      k->FilePath = this->FilePath.c_str();
-      if(k->Delim == cmListFileArgument::Bracket)
-        {
-        arg.Value = k->Value;
-        }
-      else
-        {
-        tmps = k->Value;
-        // replace formal arguments
-        for (unsigned int j = 1; j < this->Args.size(); ++j)
-          {
-          variable = "${";
-          variable += this->Args[j];
-          variable += "}";
-          cmSystemTools::ReplaceString(tmps, variable.c_str(),
-                                       expandedArgs[j-1].c_str());
-          }
-        // replace argc
-        cmSystemTools::ReplaceString(tmps, "${ARGC}",argcDef.c_str());
-
-        // repleace ARGN
-        if (tmps.find("${ARGN}") != std::string::npos)
-          {
-          if (!argnDefInitialized)
-            {
-            std::vector<std::string>::const_iterator eit;
-            std::vector<std::string>::size_type cnt = 0;
-            for(eit = expandedArgs.begin(); eit != expandedArgs.end(); ++eit)
-              {
-              if ( cnt >= this->Args.size()-1 )
-                {
-                if ( argnDef.size() > 0 )
-                  {
-                  argnDef += ";";
-                  }
-                argnDef += *eit;
-                }
-              cnt ++;
-              }
-            argnDefInitialized = true;
-            }
-          cmSystemTools::ReplaceString(tmps, "${ARGN}", argnDef.c_str());
-          }
-
-        // if the current argument of the current function has ${ARGV in it
-        // then try replacing ARGV values
-        if (tmps.find("${ARGV") != std::string::npos)
-          {
-          char argvName[60];
-
-          // repleace ARGV, compute it only once
-          if (!argvDefInitialized)
-            {
-            std::vector<std::string>::const_iterator eit;
-            for(eit = expandedArgs.begin(); eit != expandedArgs.end(); ++eit)
-              {
-              if ( argvDef.size() > 0 )
-                {
-                argvDef += ";";
-                }
-              argvDef += *eit;
-              }
-            argvDefInitialized = true;
-            }
-          cmSystemTools::ReplaceString(tmps, "${ARGV}", argvDef.c_str());
-
-          // also replace the ARGV1 ARGV2 ... etc
-          for (unsigned int t = 0; t < expandedArgs.size(); ++t)
-            {
-            sprintf(argvName,"${ARGV%i}",t);
-            cmSystemTools::ReplaceString(tmps, argvName,
-                                         expandedArgs[t].c_str());
-            }
-          }
-
-        arg.Value = tmps;
-        }
-      arg.Delim = k->Delim;
-      arg.FilePath = k->FilePath;
-      arg.Line = k->Line;
-      newLFF.Arguments.push_back(arg);
+      cmListFileArgument const& karg = func.Arguments[k];
+      cmListFileArgument& arg = newLFF.Arguments[k];
+      invocation.Substitute(karg,
+                            body->Compiled? &body->Forms[c][k] : 0,
+                            arg.Value);
+      arg.Delim = karg.Delim;
+      arg.FilePath = karg.FilePath;
+      arg.Line = karg.Line;
       }
     cmExecutionStatus status;
     if(!this->Makefile->ExecuteCommand(newLFF, status) ||
@@ -271,10 +597,13 @@ IsFunctionBlocked(const cmListFileFunction& lff, cmMakefile &mf,
       name += " )";
       mf.AddMacro(this->Args[0].c_str(), name.c_str());
       // create a new command and add it to cmake
-      cmMacroHelperCommand *f = new cmMacroHelperCommand();
-      f->Args = this->Args;
-      f->Functions = this->Functions;
-      mf.RecordPolicies(f->Policies);
+      cmMacroBody* body = new cmMacroBody;
+      body->Args = this->Args;
+      body->Functions = this->Functions;
+      mf.RecordPolicies(body->Policies);
+      body->Compile();
+      cmMacroHelperCommand *f = new cmMacroHelperCommand(body);
+      body->UnRegister();
       std::string newName = "_" + this->Args[0];
       mf.GetCMakeInstance()->RenameCommand(this->Args[0],
                                            newName);
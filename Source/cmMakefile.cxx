@@ -44,7 +44,7 @@
 class cmMakefile::Internals
 {
 public:
-  std::stack<cmDefinitions, std::list<cmDefinitions> > VarStack;
+  cmDefinitions VarStack;
   std::stack<std::set<std::string> > VarInitStack;
   std::stack<std::set<std::string> > VarUsageStack;
   bool IsSourceFileTryCompile;
@@ -53,9 +53,8 @@ public:
 // default is not to be building executables
 cmMakefile::cmMakefile(): Internal(new Internals)
 {
-  const cmDefinitions& defs = cmDefinitions();
-  const std::set<std::string> globalKeys = defs.LocalKeys();
-  this->Internal->VarStack.push(defs);
+  const std::set<std::string> globalKeys =
+    this->Internal->VarStack.LocalKeys();
   this->Internal->VarInitStack.push(globalKeys);
   this->Internal->VarUsageStack.push(globalKeys);
   this->Internal->IsSourceFileTryCompile = false;
@@ -108,7 +107,7 @@ cmMakefile::cmMakefile(): Internal(new Internals)
 
 cmMakefile::cmMakefile(const cmMakefile& mf): Internal(new Internals)
 {
-  this->Internal->VarStack.push(mf.Internal->VarStack.top().Closure());
+  this->Internal->VarStack = mf.Internal->VarStack.Closure();
   this->Internal->VarInitStack.push(mf.Internal->VarInitStack.top());
   this->Internal->VarUsageStack.push(mf.Internal->VarUsageStack.top());
 
@@ -388,17 +387,28 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
     return result;
     }
 
-  std::string name = lff.Name;
-
   // Place this call on the call stack.
   cmMakefileCall stack_manager(this, lff, status);
   static_cast<void>(stack_manager);
 
   // Lookup the command prototype.
-  if(cmCommand* proto = this->GetCMakeInstance()->GetCommand(name))
+  if(cmCommand* proto = this->GetCMakeInstance()->GetCommand(lff))
     {
-    // Clone the prototype.
-    cmsys::auto_ptr<cmCommand> pcmd(proto->Clone());
+    // Clone the prototype unless it can be invoked directly.  The
+    // prototype may be invoked again while it runs, e.g. from a
+    // variable watch, so restore its makefile afterwards.
+    cmsys::auto_ptr<cmCommand> clone;
+    cmCommand* pcmd = proto;
+    cmMakefile* protoMakefile = proto->GetMakefile();
+    if(proto->IsStateless())
+      {
+      proto->ClearError();
+      }
+    else
+      {
+      clone.reset(proto->Clone());
+      pcmd = clone.get();
+      }
     pcmd->SetMakefile(this);
 
     // Decide whether to invoke the command.
@@ -427,10 +437,10 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
           cmSystemTools::SetFatalErrorOccured();
           }
         }
-      else if(pcmd->HasFinalPass())
+      else if(clone.get() && pcmd->HasFinalPass())
         {
         // use the command
-        this->FinalPassCommands.push_back(pcmd.release());
+        this->FinalPassCommands.push_back(clone.release());
         }
       }
     else if ( this->GetCMakeInstance()->GetWorkingMode() == cmake::SCRIPT_MODE
@@ -443,6 +453,10 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
       result = false;
       cmSystemTools::SetFatalErrorOccured();
       }
+    if(pcmd == proto)
+      {
+      proto->SetMakefile(protoMakefile);
+      }
     }
   else
     {
@@ -1573,7 +1587,7 @@ void cmMakefile::InitializeFromParent()
   cmMakefile *parent = this->LocalGenerator->GetParent()->GetMakefile();
 
   // Initialize definitions with the closure of the parent scope.
-  this->Internal->VarStack.top() = parent->Internal->VarStack.top().Closure();
+  this->Internal->VarStack = parent->Internal->VarStack.Closure();
 
   const std::vector<cmValueWithOrigin>& parentIncludes =
                                         parent->GetIncludeDirectoriesEntries();
@@ -1781,7 +1795,7 @@ void cmMakefile::AddDefinition(const std::string& name, const char* value)
     return;
     }
 
-  this->Internal->VarStack.top().Set(name, value);
+  this->Internal->VarStack.Set(name, value);
   if (this->Internal->VarUsageStack.size() &&
       this->VariableInitialized(name))
     {
@@ -1850,13 +1864,13 @@ void cmMakefile::AddCacheDefinition(const std::string& name, const char* value,
   this->GetCacheManager()->AddCacheEntry(name, haveVal ? val.c_str() : 0, doc,
                                          type);
   // if there was a definition then remove it
-  this->Internal->VarStack.top().Set(name, 0);
+  this->Internal->VarStack.Set(name, 0);
 }
 
 
 void cmMakefile::AddDefinition(const std::string& name, bool value)
 {
-  this->Internal->VarStack.top().Set(name, value? "ON" : "OFF");
+  this->Internal->VarStack.Set(name, value? "ON" : "OFF");
   if (this->Internal->VarUsageStack.size() &&
       this->VariableInitialized(name))
     {
@@ -1880,7 +1894,7 @@ void cmMakefile::CheckForUnusedVariables() const
     {
     return;
     }
-  const cmDefinitions& defs = this->Internal->VarStack.top();
+  const cmDefinitions& defs = this->Internal->VarStack;
   const std::set<std::string>& locals = defs.LocalKeys();
   std::set<std::string>::const_iterator it = locals.begin();
   for (; it != locals.end(); ++it)
@@ -1955,7 +1969,7 @@ void cmMakefile::CheckForUnused(const char* reason,
 
 void cmMakefile::RemoveDefinition(const std::string& name)
 {
-  this->Internal->VarStack.top().Set(name, 0);
+  this->Internal->VarStack.Set(name, 0);
   if (this->Internal->VarUsageStack.size() &&
       this->VariableInitialized(name))
     {
@@ -2429,7 +2443,7 @@ const char* cmMakefile::GetRequiredDefinition(const std::string& name) const
 
 bool cmMakefile::IsDefinitionSet(const std::string& name) const
 {
-  const char* def = this->Internal->VarStack.top().Get(name);
+  const char* def = this->Internal->VarStack.Get(name);
   this->Internal->VarUsageStack.top().insert(name);
   if(!def)
     {
@@ -2455,7 +2469,7 @@ const char* cmMakefile::GetDefinition(const std::string& name) const
     {
     this->Internal->VarUsageStack.top().insert(name);
     }
-  const char* def = this->Internal->VarStack.top().Get(name);
+  const char* def = this->Internal->VarStack.Get(name);
   if(!def)
     {
     def = this->GetCacheManager()->GetCacheValue(name);
@@ -2495,7 +2509,7 @@ std::vector<std::string> cmMakefile
   std::set<std::string> definitions;
   if ( !cacheonly )
     {
-    definitions = this->Internal->VarStack.top().ClosureKeys();
+    definitions = this->Internal->VarStack.ClosureKeys();
     }
   cmCacheManager::CacheIterator cit =
     this->GetCacheManager()->GetCacheIterator();
@@ -2529,6 +2543,13 @@ const char *cmMakefile::ExpandVariablesInString(std::string& source,
                                                 bool removeEmpty,
                                                 bool replaceAt) const
 {
+  // Fast path strings without any special characters.  Both the old
+  // and new evaluation rules leave them untouched.
+  if(source.find_first_of("$@\\") == source.npos)
+    {
+    return source.c_str();
+    }
+
   bool compareResults = false;
   cmake::MessageType mtype = cmake::LOG;
   std::string errorstr;
@@ -2802,7 +2823,9 @@ cmake::MessageType cmMakefile::ExpandVariablesInStringNew(
   const char* last = in;
   std::string result;
   result.reserve(source.size());
-  std::stack<t_lookup> openstack;
+  // Reuse one buffer for the names of all variable references.
+  std::string lookupBuffer;
+  std::stack<t_lookup, std::vector<t_lookup> > openstack;
   bool error = false;
   bool done = false;
   openstack.push(t_lookup());
@@ -2819,18 +2842,18 @@ cmake::MessageType cmMakefile::ExpandVariablesInStringNew(
           t_lookup var = openstack.top();
           openstack.pop();
           result.append(last, in - last);
-          std::string const& lookup = result.substr(var.loc);
+          lookupBuffer.assign(result, var.loc, result.npos);
+          std::string const& lookup = lookupBuffer;
           const char* value = NULL;
-          std::string varresult;
+          char lineStr[32];
           static const std::string lineVar = "CMAKE_CURRENT_LIST_LINE";
           switch(var.domain)
             {
             case NORMAL:
               if(filename && lookup == lineVar)
                 {
-                cmOStringStream ostr;
-                ostr << line;
-                varresult = ostr.str();
+                sprintf(lineStr, "%ld", line);
+                value = lineStr;
                 }
               else
                 {
@@ -2844,16 +2867,17 @@ cmake::MessageType cmMakefile::ExpandVariablesInStringNew(
               value = this->GetCacheManager()->GetCacheValue(lookup);
               break;
             }
-          // Get the string we're meant to append to.
+          // Replace the reference with the value in place.
+          result.erase(var.loc);
           if(value)
             {
             if(escapeQuotes)
               {
-              varresult = cmSystemTools::EscapeQuotes(value);
+              result += cmSystemTools::EscapeQuotes(value);
               }
             else
               {
-              varresult = value;
+              result += value;
               }
             }
           else if(!removeEmpty)
@@ -2882,7 +2906,6 @@ cmake::MessageType cmMakefile::ExpandVariablesInStringNew(
                 }
               }
             }
-          result.replace(var.loc, result.size() - var.loc, varresult);
           // Start looking from here on out.
           last = in + 1;
           }
@@ -3085,7 +3108,7 @@ cmake::MessageType cmMakefile::ExpandVariablesInStringNew(
     // Append the rest of the unchanged part of the string.
     result.append(last);
 
-    source = result;
+    source.swap(result);
     }
 
   return mtype;
@@ -3307,21 +3330,27 @@ bool cmMakefile::ExpandArguments(
       outArgs.push_back(i->Value);
       continue;
       }
-    // Expand the variables in the argument.
-    value = i->Value;
-    this->ExpandVariablesInString(value, false, false, false,
-                                  i->FilePath, i->Line,
-                                  false, false);
+    // Expand the variables in the argument.  Arguments without any
+    // special characters are used as they are without a copy.
+    std::string const* expanded = &i->Value;
+    if(i->Value.find_first_of("$@\\") != i->Value.npos)
+      {
+      value = i->Value;
+      this->ExpandVariablesInString(value, false, false, false,
+                                    i->FilePath, i->Line,
+                                    false, false);
+      expanded = &value;
+      }
 
     // If the argument is quoted, it should be one argument.
     // Otherwise, it may be a list of arguments.
     if(i->Delim == cmListFileArgument::Quoted)
       {
-      outArgs.push_back(value);
+      outArgs.push_back(*expanded);
       }
     else
       {
-      cmSystemTools::ExpandListArgument(value, outArgs);
+      cmSystemTools::ExpandListArgument(*expanded, outArgs);
       }
     }
   return !cmSystemTools::GetFatalErrorOccured();
@@ -4377,20 +4406,18 @@ std::string cmMakefile::GetListFileStack() const
 
 void cmMakefile::PushScope()
 {
-  cmDefinitions* parent = &this->Internal->VarStack.top();
   const std::set<std::string>& init = this->Internal->VarInitStack.top();
   const std::set<std::string>& usage = this->Internal->VarUsageStack.top();
-  this->Internal->VarStack.push(cmDefinitions(parent));
+  this->Internal->VarStack.PushScope();
   this->Internal->VarInitStack.push(init);
   this->Internal->VarUsageStack.push(usage);
 }
 
 void cmMakefile::PopScope()
 {
-  cmDefinitions* current = &this->Internal->VarStack.top();
   std::set<std::string> init = this->Internal->VarInitStack.top();
   std::set<std::string> usage = this->Internal->VarUsageStack.top();
-  const std::set<std::string>& locals = current->LocalKeys();
+  const std::set<std::string>& locals = this->Internal->VarStack.LocalKeys();
   // Remove initialization and usage information for variables in the local
   // scope.
   std::set<std::string>::const_iterator it = locals.begin();
@@ -4406,7 +4433,7 @@ void cmMakefile::PopScope()
       usage.erase(*it);
       }
     }
-  this->Internal->VarStack.pop();
+  this->Internal->VarStack.PopScope();
   this->Internal->VarInitStack.pop();
   this->Internal->VarUsageStack.pop();
   // Push initialization and usage up to the parent scope.
@@ -4429,14 +4456,12 @@ void cmMakefile::RaiseScope(const std::string& var, const char *varDef)
     return;
     }
 
-  cmDefinitions& cur = this->Internal->VarStack.top();
-  if(cmDefinitions* up = cur.GetParent())
+  cmDefinitions& cur = this->Internal->VarStack;
+  if(cur.HasParentScope())
     {
-    // First localize the definition in the current scope.
-    cur.Pull(var);
-
-    // Now update the definition in the parent scope.
-    up->Set(var, varDef);
+    // Localize the definition in the current scope and update the
+    // definition in the parent scope.
+    cur.RaiseScope(var, varDef);
     }
   else if(cmLocalGenerator* plg = this->LocalGenerator->GetParent())
     {
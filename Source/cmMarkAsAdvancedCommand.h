@@ -42,6 +42,11 @@ public:
    */
   virtual std::string GetName() const {return "mark_as_advanced";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   /**
    * This determines if the command is invoked when in script mode.
    * mark_as_advanced() will have no effect in script mode, but this will
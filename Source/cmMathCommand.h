@@ -43,6 +43,11 @@ public:
    */
   virtual std::string GetName() const { return "math";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmMathCommand, cmCommand);
 protected:
 
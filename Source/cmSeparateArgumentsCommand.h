@@ -47,6 +47,11 @@ public:
    */
   virtual std::string GetName() const {return "separate_arguments";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmSeparateArgumentsCommand, cmCommand);
 };
 
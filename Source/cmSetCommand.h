@@ -47,6 +47,11 @@ public:
    */
   virtual std::string GetName() const {return "set";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmSetCommand, cmCommand);
 };
 
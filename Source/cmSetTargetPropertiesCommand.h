@@ -34,6 +34,11 @@ public:
    */
   virtual std::string GetName() const { return "set_target_properties";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   /**
    *  Used by this command and cmSetPropertiesCommand
    */
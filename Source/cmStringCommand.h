@@ -52,6 +52,11 @@ public:
    */
   virtual std::string GetName() const { return "string";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmStringCommand, cmCommand);
 protected:
   bool HandleConfigureCommand(std::vector<std::string> const& args);
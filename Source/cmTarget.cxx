@@ -230,9 +230,63 @@ public:
   std::map<std::string, bool> CacheLinkInterfaceCompileOptionsDone;
   std::map<std::string, bool> CacheLinkInterfaceSourcesDone;
   std::map<std::string, bool> CacheLinkInterfaceCompileFeaturesDone;
+
+  // Cache usage requirements computed at generate time for each
+  // configuration.  Results are dropped when any target property
+  // changes because they depend on the whole link closure.
+  struct UsageRequirementsCache
+  {
+    UsageRequirementsCache(): Generation(0) {}
+    std::vector<std::string> const* Find(std::string const& config);
+    void Store(std::string const& config,
+               std::vector<std::string> const& values);
+    unsigned long Generation;
+    std::map<std::string, std::vector<std::string> > Values;
+  };
+  UsageRequirementsCache IncludeDirectoriesCache;
+  UsageRequirementsCache CompileOptionsCache;
+  UsageRequirementsCache CompileDefinitionsCache;
+
+  // Incremented whenever a property of any target changes.
+  static unsigned long PropertiesGeneration;
+  static unsigned long UsageRequirementsHits;
+  static unsigned long UsageRequirementsMisses;
 };
 
 cmLinkImplItem cmTargetInternals::TargetPropertyEntry::NoLinkImplItem;
+unsigned long cmTargetInternals::PropertiesGeneration = 1;
+unsigned long cmTargetInternals::UsageRequirementsHits = 0;
+unsigned long cmTargetInternals::UsageRequirementsMisses = 0;
+
+//----------------------------------------------------------------------------
+std::vector<std::string> const*
+cmTargetInternals::UsageRequirementsCache::Find(std::string const& config)
+{
+  if(this->Generation != cmTargetInternals::PropertiesGeneration)
+    {
+    this->Values.clear();
+    this->Generation = cmTargetInternals::PropertiesGeneration;
+    }
+  std::map<std::string, std::vector<std::string> >::const_iterator i =
+    this->Values.find(config);
+  if(i == this->Values.end())
+    {
+    ++cmTargetInternals::UsageRequirementsMisses;
+    return 0;
+    }
+  ++cmTargetInternals::UsageRequirementsHits;
+  return &i->second;
+}
+
+//----------------------------------------------------------------------------
+void cmTargetInternals::UsageRequirementsCache
+::Store(std::string const& config, std::vector<std::string> const& values)
+{
+  if(this->Generation == cmTargetInternals::PropertiesGeneration)
+    {
+    this->Values[config] = values;
+    }
+}
 
 //----------------------------------------------------------------------------
 static void deleteAndClear(
@@ -271,6 +325,14 @@ cmTargetInternals::~cmTargetInternals()
   deleteAndClear(this->CachedLinkInterfaceSourcesEntries);
 }
 
+//----------------------------------------------------------------------------
+void cmTarget::GetUsageRequirementsCacheStats(unsigned long& hits,
+                                              unsigned long& misses)
+{
+  hits = cmTargetInternals::UsageRequirementsHits;
+  misses = cmTargetInternals::UsageRequirementsMisses;
+}
+
 //----------------------------------------------------------------------------
 cmTarget::cmTarget()
 {
@@ -1763,6 +1825,7 @@ static bool whiteListedInterfaceProperty(const std::string& prop)
 //----------------------------------------------------------------------------
 void cmTarget::SetProperty(const std::string& prop, const char* value)
 {
+  ++cmTargetInternals::PropertiesGeneration;
   if (this->GetType() == INTERFACE_LIBRARY
       && !whiteListedInterfaceProperty(prop))
     {
@@ -1858,6 +1921,7 @@ void cmTarget::SetProperty(const std::string& prop, const char* value)
 void cmTarget::AppendProperty(const std::string& prop, const char* value,
                               bool asString)
 {
+  ++cmTargetInternals::PropertiesGeneration;
   if (this->GetType() == INTERFACE_LIBRARY
       && !whiteListedInterfaceProperty(prop))
     {
@@ -1995,6 +2059,7 @@ void cmTarget::AppendBuildInterfaceIncludes()
 void cmTarget::InsertInclude(const cmValueWithOrigin &entry,
                      bool before)
 {
+  ++cmTargetInternals::PropertiesGeneration;
   cmGeneratorExpression ge(&entry.Backtrace);
 
   std::vector<cmTargetInternals::TargetPropertyEntry*>::iterator position
@@ -2009,6 +2074,7 @@ void cmTarget::InsertInclude(const cmValueWithOrigin &entry,
 void cmTarget::InsertCompileOption(const cmValueWithOrigin &entry,
                      bool before)
 {
+  ++cmTargetInternals::PropertiesGeneration;
   cmGeneratorExpression ge(&entry.Backtrace);
 
   std::vector<cmTargetInternals::TargetPropertyEntry*>::iterator position
@@ -2022,6 +2088,7 @@ void cmTarget::InsertCompileOption(const cmValueWithOrigin &entry,
 //----------------------------------------------------------------------------
 void cmTarget::InsertCompileDefinition(const cmValueWithOrigin &entry)
 {
+  ++cmTargetInternals::PropertiesGeneration;
   cmGeneratorExpression ge(&entry.Backtrace);
 
   this->Internal->CompileDefinitionsEntries.push_back(
@@ -2205,6 +2272,17 @@ cmTarget::GetIncludeDirectories(const std::string& config) const
     this->DebugIncludesDone = true;
     }
 
+  bool useCache =
+    this->Makefile->IsGeneratingBuildSystem() && !debugIncludes;
+  if (useCache)
+    {
+    if (std::vector<std::string> const* cached =
+        this->Internal->IncludeDirectoriesCache.Find(config))
+      {
+      return *cached;
+      }
+    }
+
   processIncludeDirectories(this,
                             this->Internal->IncludeDirectoriesEntries,
                             includes,
@@ -2266,6 +2344,10 @@ cmTarget::GetIncludeDirectories(const std::string& config) const
                                                                       = true;
     }
 
+  if (useCache)
+    {
+    this->Internal->IncludeDirectoriesCache.Store(config, includes);
+    }
   return includes;
 }
 
@@ -2397,9 +2479,22 @@ void cmTarget::GetCompileOptions(std::vector<std::string> &result,
     this->DebugCompileOptionsDone = true;
     }
 
+  bool useCache =
+    this->Makefile->IsGeneratingBuildSystem() && !debugOptions;
+  if (useCache)
+    {
+    if (std::vector<std::string> const* cached =
+        this->Internal->CompileOptionsCache.Find(config))
+      {
+      result.insert(result.end(), cached->begin(), cached->end());
+      return;
+      }
+    }
+
+  std::vector<std::string> options;
   processCompileOptions(this,
                             this->Internal->CompileOptionsEntries,
-                            result,
+                            options,
                             uniqueOptions,
                             &dagChecker,
                             config,
@@ -2414,7 +2509,7 @@ void cmTarget::GetCompileOptions(std::vector<std::string> &result,
 
   processCompileOptions(this,
     this->Internal->CachedLinkInterfaceCompileOptionsEntries[config],
-                            result,
+                            options,
                             uniqueOptions,
                             &dagChecker,
                             config,
@@ -2428,6 +2523,12 @@ void cmTarget::GetCompileOptions(std::vector<std::string> &result,
     {
     this->Internal->CacheLinkInterfaceCompileOptionsDone[config] = true;
     }
+
+  if (useCache)
+    {
+    this->Internal->CompileOptionsCache.Store(config, options);
+    }
+  result.insert(result.end(), options.begin(), options.end());
 }
 
 //----------------------------------------------------------------------------
@@ -2471,9 +2572,22 @@ void cmTarget::GetCompileDefinitions(std::vector<std::string> &list,
     this->DebugCompileDefinitionsDone = true;
     }
 
+  bool useCache =
+    this->Makefile->IsGeneratingBuildSystem() && !debugDefines;
+  if (useCache)
+    {
+    if (std::vector<std::string> const* cached =
+        this->Internal->CompileDefinitionsCache.Find(config))
+      {
+      list.insert(list.end(), cached->begin(), cached->end());
+      return;
+      }
+    }
+
+  std::vector<std::string> definitions;
   processCompileDefinitions(this,
                             this->Internal->CompileDefinitionsEntries,
-                            list,
+                            definitions,
                             uniqueOptions,
                             &dagChecker,
                             config,
@@ -2523,7 +2637,7 @@ void cmTarget::GetCompileDefinitions(std::vector<std::string> &list,
 
   processCompileDefinitions(this,
     this->Internal->CachedLinkInterfaceCompileDefinitionsEntries[config],
-                            list,
+                            definitions,
                             uniqueOptions,
                             &dagChecker,
                             config,
@@ -2539,6 +2653,12 @@ void cmTarget::GetCompileDefinitions(std::vector<std::string> &list,
     this->Internal->CacheLinkInterfaceCompileDefinitionsDone[config]
                                                                       = true;
     }
+
+  if (useCache)
+    {
+    this->Internal->CompileDefinitionsCache.Store(config, definitions);
+    }
+  list.insert(list.end(), definitions.begin(), definitions.end());
 }
 
 //----------------------------------------------------------------------------
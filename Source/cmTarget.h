@@ -583,6 +583,11 @@ public:
   void GetCompileFeatures(std::vector<std::string> &features,
                           const std::string& config) const;
 
+  /** Get the number of include directory, compile option and compile
+      definition lookups answered from the generate-time cache.  */
+  static void GetUsageRequirementsCacheStats(unsigned long& hits,
+                                             unsigned long& misses);
+
   bool IsNullImpliedByLinkLibraries(const std::string &p) const;
   bool IsLinkInterfaceDependentBoolProperty(const std::string &p,
                          const std::string& config) const;
@@ -68,6 +68,11 @@ public:
    */
   virtual std::string GetName() const { return "while";}
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmWhileCommand, cmCommand);
 };
 
@@ -16,6 +16,7 @@
 #include "cmExternalMakefileProjectGenerator.h"
 #include "cmCommands.h"
 #include "cmCommand.h"
+#include "cmDependsC.h"
 #include "cmFileTimeComparison.h"
 #include "cmSourceFile.h"
 #include "cmTest.h"
@@ -154,6 +155,7 @@ cmake::cmake()
   this->VariableWatch = new cmVariableWatch;
 #endif
 
+  this->NewCommandsGeneration();
   this->AddDefaultGenerators();
   this->AddDefaultExtraGenerators();
   this->AddDefaultCommands();
@@ -162,6 +164,16 @@ cmake::cmake()
   cmSystemTools::EnableVSConsoleOutput();
 }
 
+// Source of process-wide unique commands generations, so that a command
+// remembered by a cmListFileFunction is never taken from another instance
+// or from a replaced or removed command.
+static unsigned long cmakeCommandsGeneration = 0;
+
+void cmake::NewCommandsGeneration()
+{
+  this->CommandsGeneration = ++cmakeCommandsGeneration;
+}
+
 cmake::~cmake()
 {
   delete this->CacheManager;
@@ -217,6 +229,7 @@ void cmake::CleanupCommandsAndMacros()
       }
     }
   this->Commands.erase(this->Commands.begin(), this->Commands.end());
+  this->NewCommandsGeneration();
   std::vector<cmCommand*>::iterator it;
   for ( it = commands.begin(); it != commands.end();
     ++ it )
@@ -243,6 +256,21 @@ cmCommand *cmake::GetCommand(const std::string& name)
   return rm;
 }
 
+cmCommand *cmake::GetCommand(cmListFileFunction const& lff)
+{
+  // Only a command found is remembered since adding a command may give
+  // a meaning to a name that had none.
+  if(!lff.Command ||
+     lff.CommandGeneration != this->CommandsGeneration ||
+     lff.CommandName != lff.Name)
+    {
+    lff.Command = this->GetCommand(lff.Name);
+    lff.CommandName = lff.Name;
+    lff.CommandGeneration = this->CommandsGeneration;
+    }
+  return lff.Command;
+}
+
 void cmake::RenameCommand(const std::string& oldName,
                           const std::string& newName)
 {
@@ -255,6 +283,7 @@ void cmake::RenameCommand(const std::string& oldName,
     return;
     }
   cmCommand* cmd = pos->second;
+  this->NewCommandsGeneration();
 
   pos = this->Commands.find(sNewName);
   if (pos != this->Commands.end())
@@ -275,6 +304,7 @@ void cmake::RemoveCommand(const std::string& name)
     {
     delete pos->second;
     this->Commands.erase(pos);
+    this->NewCommandsGeneration();
     }
 }
 
@@ -287,6 +317,7 @@ void cmake::AddCommand(cmCommand* wg)
     {
     delete pos->second;
     this->Commands.erase(pos);
+    this->NewCommandsGeneration();
     }
   this->Commands.insert( RegisteredCommandsMap::value_type(name, wg));
 }
@@ -1488,8 +1519,23 @@ int cmake::ActualConfigure()
     this->TruncateOutputLog("CMakeError.log");
     }
 
+  // Reuse list files parsed by a previous run.
+  std::string listFileCache;
+  if (!this->InTryCompile && this->GetWorkingMode() == NORMAL_MODE)
+    {
+    listFileCache = this->GetHomeOutputDirectory();
+    listFileCache += this->GetCMakeFilesDirectory();
+    listFileCache += "/ListFileCache.bin";
+    cmListFileCache::GetInstance()->Load(listFileCache);
+    }
+
   // actually do the configure
   this->GlobalGenerator->Configure();
+
+  if (!listFileCache.empty() && !cmSystemTools::GetFatalErrorOccured())
+    {
+    cmListFileCache::GetInstance()->Save(listFileCache);
+    }
   // Before saving the cache
   // if the project did not define one of the entries below, add them now
   // so users can edit the values in the cache:
@@ -1661,6 +1707,14 @@ int cmake::Run(const std::vector<std::string>& args, bool noconfigure)
     return 0;
     }
 
+  // The check runs before anything else in a build of the Makefile
+  // generators.  Merge the include scans saved by the dependency
+  // scanning of the targets while no scanning can run concurrently.
+  if(!this->CheckBuildSystemArgument.empty())
+    {
+    cmDependsC::MergeIncludeScans(this->GetHomeOutputDirectory());
+    }
+
   // now run the global generate
   // Check the state of the build system to see if we need to regenerate.
   if(!this->CheckBuildSystem())
@@ -1943,52 +1997,75 @@ int cmake::CheckBuildSystem()
     return 1;
     }
 
-  // Read the rerun check file and use it to decide whether to do the
-  // global generate.
-  cmake cm;
-  cmGlobalGenerator gg;
-  gg.SetCMakeInstance(&cm);
-  cmsys::auto_ptr<cmLocalGenerator> lg(gg.CreateLocalGenerator());
-  cmMakefile* mf = lg->GetMakefile();
-  if(!mf->ReadListFile(0, this->CheckBuildSystemArgument.c_str()) ||
-     cmSystemTools::GetErrorOccuredFlag())
-    {
-    if(verbose)
+  // Unless dependencies must be cleared, read the lists of files to
+  // check from the plain check file written next to the rerun check
+  // file.  This avoids running the CMake language interpreter.
+  std::vector<std::string> products;
+  std::vector<std::string> depends;
+  std::vector<std::string> outputs;
+  if(this->ClearBuildSystem ||
+     !this->ReadCheckBuildSystemFile(products, depends, outputs))
+    {
+    products.clear();
+    depends.clear();
+    outputs.clear();
+
+    // Read the rerun check file and use it to decide whether to do the
+    // global generate.
+    cmake cm;
+    cmGlobalGenerator gg;
+    gg.SetCMakeInstance(&cm);
+    cmsys::auto_ptr<cmLocalGenerator> lg(gg.CreateLocalGenerator());
+    cmMakefile* mf = lg->GetMakefile();
+    if(!mf->ReadListFile(0, this->CheckBuildSystemArgument.c_str()) ||
+       cmSystemTools::GetErrorOccuredFlag())
       {
-      cmOStringStream msg;
-      msg << "Re-run cmake error reading : "
-          << this->CheckBuildSystemArgument << "\n";
-      cmSystemTools::Stdout(msg.str().c_str());
+      if(verbose)
+        {
+        cmOStringStream msg;
+        msg << "Re-run cmake error reading : "
+            << this->CheckBuildSystemArgument << "\n";
+        cmSystemTools::Stdout(msg.str().c_str());
+        }
+      // There was an error reading the file.  Just rerun.
+      return 1;
       }
-    // There was an error reading the file.  Just rerun.
-    return 1;
-    }
 
-  if(this->ClearBuildSystem)
-    {
-    // Get the generator used for this build system.
-    const char* genName = mf->GetDefinition("CMAKE_DEPENDS_GENERATOR");
-    if(!genName || genName[0] == '\0')
+    if(this->ClearBuildSystem)
       {
-      genName = "Unix Makefiles";
+      // Get the generator used for this build system.
+      const char* genName = mf->GetDefinition("CMAKE_DEPENDS_GENERATOR");
+      if(!genName || genName[0] == '\0')
+        {
+        genName = "Unix Makefiles";
+        }
+
+      // Create the generator and use it to clear the dependencies.
+      cmsys::auto_ptr<cmGlobalGenerator>
+        ggd(this->CreateGlobalGenerator(genName));
+      if(ggd.get())
+        {
+        cmsys::auto_ptr<cmLocalGenerator> lgd(ggd->CreateLocalGenerator());
+        lgd->ClearDependencies(mf, verbose);
+        }
       }
 
-    // Create the generator and use it to clear the dependencies.
-    cmsys::auto_ptr<cmGlobalGenerator>
-      ggd(this->CreateGlobalGenerator(genName));
-    if(ggd.get())
+    // Get the set of byproducts, dependencies and outputs.
+    if(const char* productStr =
+       mf->GetDefinition("CMAKE_MAKEFILE_PRODUCTS"))
       {
-      cmsys::auto_ptr<cmLocalGenerator> lgd(ggd->CreateLocalGenerator());
-      lgd->ClearDependencies(mf, verbose);
+      cmSystemTools::ExpandListArgument(productStr, products);
+      }
+    const char* dependsStr = mf->GetDefinition("CMAKE_MAKEFILE_DEPENDS");
+    const char* outputsStr = mf->GetDefinition("CMAKE_MAKEFILE_OUTPUTS");
+    if(dependsStr && outputsStr)
+      {
+      cmSystemTools::ExpandListArgument(dependsStr, depends);
+      cmSystemTools::ExpandListArgument(outputsStr, outputs);
       }
     }
 
   // If any byproduct of makefile generation is missing we must re-run.
-  std::vector<std::string> products;
-  if(const char* productStr = mf->GetDefinition("CMAKE_MAKEFILE_PRODUCTS"))
-    {
-    cmSystemTools::ExpandListArgument(productStr, products);
-    }
   for(std::vector<std::string>::const_iterator pi = products.begin();
       pi != products.end(); ++pi)
     {
@@ -2005,16 +2082,6 @@ int cmake::CheckBuildSystem()
       }
     }
 
-  // Get the set of dependencies and outputs.
-  std::vector<std::string> depends;
-  std::vector<std::string> outputs;
-  const char* dependsStr = mf->GetDefinition("CMAKE_MAKEFILE_DEPENDS");
-  const char* outputsStr = mf->GetDefinition("CMAKE_MAKEFILE_OUTPUTS");
-  if(dependsStr && outputsStr)
-    {
-    cmSystemTools::ExpandListArgument(dependsStr, depends);
-    cmSystemTools::ExpandListArgument(outputsStr, outputs);
-    }
   if(depends.empty() || outputs.empty())
     {
     // Not enough information was provided to do the test.  Just rerun.
@@ -2103,6 +2170,50 @@ int cmake::CheckBuildSystem()
   return 0;
 }
 
+//----------------------------------------------------------------------------
+bool cmake::ReadCheckBuildSystemFile(std::vector<std::string>& products,
+                                     std::vector<std::string>& depends,
+                                     std::vector<std::string>& outputs)
+{
+  // The check file is written by the generator right after the rerun
+  // check file.  Do not trust it if it is older, for example because
+  // the rerun check file was written by a CMake that does not know it.
+  std::string checkFile = this->CheckBuildSystemArgument + ".check";
+  int result = 0;
+  if(!this->FileComparison->FileTimeCompare(
+       checkFile.c_str(), this->CheckBuildSystemArgument.c_str(), &result) ||
+     result < 0)
+    {
+    return false;
+    }
+  cmsys::ifstream fin(checkFile.c_str());
+  if(!fin)
+    {
+    return false;
+    }
+  std::string line;
+  while(cmSystemTools::GetLineFromStream(fin, line))
+    {
+    if(line.size() < 3 || line[1] != ' ')
+      {
+      continue;
+      }
+    if(line[0] == 'P')
+      {
+      products.push_back(line.substr(2));
+      }
+    else if(line[0] == 'D')
+      {
+      depends.push_back(line.substr(2));
+      }
+    else if(line[0] == 'O')
+      {
+      outputs.push_back(line.substr(2));
+      }
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void cmake::TruncateOutputLog(const char* fname)
 {
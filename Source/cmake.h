@@ -229,6 +229,12 @@ class cmake
    */
   cmCommand *GetCommand(const std::string& name);
 
+  /**
+   * Get the command invoked by a function call.  The result is
+   * remembered by the call until a command is replaced or removed.
+   */
+  cmCommand *GetCommand(cmListFileFunction const& lff);
+
   /** Get list of all commands */
   RegisteredCommandsMap* GetCommands() { return &this->Commands; }
 
@@ -386,6 +392,10 @@ protected:
                 CreateExtraGeneratorFunctionType> RegisteredExtraGeneratorsMap;
   typedef std::vector<cmGlobalGeneratorFactory*> RegisteredGeneratorsVector;
   RegisteredCommandsMap Commands;
+  // Identifies the current set of commands of this instance among all
+  // instances.  Changed whenever a command is replaced or removed.
+  unsigned long CommandsGeneration;
+  void NewCommandsGeneration();
   RegisteredGeneratorsVector Generators;
   RegisteredExtraGeneratorsMap ExtraGenerators;
   void AddDefaultCommands();
@@ -459,6 +469,11 @@ private:
   InstalledFilesMap InstalledFiles;
 
   void UpdateConversionPathTable();
+
+  // Read the plain lists of files written next to the rerun check file.
+  bool ReadCheckBuildSystemFile(std::vector<std::string>& products,
+                                std::vector<std::string>& depends,
+                                std::vector<std::string>& outputs);
 };
 
 #define CMAKE_STANDARD_OPTIONS_TABLE \
@@ -21,7 +21,6 @@
 # include <cmsys/Terminal.h>
 #endif
 
-#include <cmsys/Directory.hxx>
 #include <cmsys/Process.h>
 #include <cmsys/FStream.hxx>
 
@@ -482,6 +481,14 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
           fprintf(progFile,"%i\n",count);
           fclose(progFile);
           }
+        // create the file recording which marks have been reached
+        fName = dirName;
+        fName += "/marks";
+        progFile = cmsys::SystemTools::Fopen(fName.c_str(),"wb");
+        if (progFile)
+          {
+          fclose(progFile);
+          }
         }
       return 0;
       }
@@ -511,25 +518,46 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
           }
         fclose(progFile);
         }
+      // Each mark owns the byte at its own offset in the marks file.
+      // Setting it is a single positioned write, so concurrent rules
+      // never lose each other's marks, and repeating a mark is harmless.
+      fName = dirName;
+      fName += "/marks";
+      progFile = cmsys::SystemTools::Fopen(fName.c_str(),"r+b");
+      if (!progFile)
+        {
+        return 0;
+        }
       unsigned int i;
       for (i = 3; i < args.size(); ++i)
         {
-        fName = dirName;
-        fName += "/";
-        fName += args[i];
-        progFile = cmsys::SystemTools::Fopen(fName.c_str(),"w");
-        if (progFile)
+        long mark = atol(args[i].c_str());
+        if (mark > 0 && fseek(progFile, mark, SEEK_SET) == 0)
           {
-          fprintf(progFile,"empty");
-          fclose(progFile);
+          fputc(1, progFile);
+          }
+        }
+      // count the marks reached so far
+      int marksReached = 0;
+      char buffer[128];
+      size_t n;
+      fflush(progFile);
+      rewind(progFile);
+      while ((n = fread(buffer, 1, sizeof(buffer), progFile)) > 0)
+        {
+        for (size_t j = 0; j < n; ++j)
+          {
+          if (buffer[j])
+            {
+            ++marksReached;
+            }
           }
         }
-      int fileNum = static_cast<int>
-        (cmsys::Directory::GetNumberOfFilesInDirectory(dirName.c_str()));
+      fclose(progFile);
       if (count > 0)
         {
         // print the progress
-        fprintf(stdout,"[%3i%%] ",((fileNum-3)*100)/count);
+        fprintf(stdout,"[%3i%%] ",(marksReached*100)/count);
         }
       return 0;
       }
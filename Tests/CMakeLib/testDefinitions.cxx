@@ -0,0 +1,118 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2014 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmDefinitions.h"
+
+static bool checkValue(cmDefinitions const& defs, const char* key,
+                       const char* expect)
+{
+  const char* value = defs.Get(key);
+  if(!expect && !value)
+    {
+    return true;
+    }
+  if(expect && value && strcmp(expect, value) == 0)
+    {
+    return true;
+    }
+  printf("%s: expected [%s], got [%s]\n", key,
+         expect? expect : "(null)", value? value : "(null)");
+  return false;
+}
+
+int testDefinitions(int, char*[])
+{
+  bool result = true;
+  cmDefinitions defs;
+
+  // Top-most scope.
+  defs.Set("A", "a0");
+  defs.Set("B", "b0");
+  defs.Set("C", "c0");
+  defs.Set("C", 0);
+  result = checkValue(defs, "A", "a0") && result;
+  result = checkValue(defs, "C", 0) && result;
+  if(defs.HasParentScope() || defs.LocalKeys().size() != 2)
+    {
+    printf("top-most scope has wrong local keys\n");
+    result = false;
+    }
+
+  // A nested scope sees outer values and shadows them locally.
+  defs.PushScope();
+  const char* outerA = defs.Get("A");
+  defs.Set("A", "a1");
+  defs.Set("B", 0);
+  defs.Set("D", "d1");
+  result = checkValue(defs, "A", "a1") && result;
+  result = checkValue(defs, "B", 0) && result;
+  if(strcmp(outerA, "a0") != 0)
+    {
+    printf("outer value changed by a nested set\n");
+    result = false;
+    }
+  std::set<std::string> local = defs.LocalKeys();
+  if(local.size() != 2 || !local.count("A") || !local.count("D"))
+    {
+    printf("nested scope has wrong local keys\n");
+    result = false;
+    }
+
+  // Closure flattens the visible values.
+  cmDefinitions closure = defs.Closure();
+  result = checkValue(closure, "A", "a1") && result;
+  result = checkValue(closure, "B", 0) && result;
+  result = checkValue(closure, "D", "d1") && result;
+  if(closure.HasParentScope() || defs.ClosureKeys().size() != 2)
+    {
+    printf("closure has wrong keys\n");
+    result = false;
+    }
+
+  // Raising a value sets it in the parent but keeps the local view.
+  defs.PushScope();
+  defs.RaiseScope("A", "a1-raised");
+  defs.RaiseScope("E", "e1");
+  result = checkValue(defs, "A", "a1") && result;
+  result = checkValue(defs, "E", "e1") && result;
+  defs.PopScope();
+  result = checkValue(defs, "A", "a1-raised") && result;
+  result = checkValue(defs, "E", "e1") && result;
+
+  // Raising a value first replaces the local binding with the value the
+  // parent sees, as in set(x 1) set(x 2 PARENT_SCOPE) reading x back.
+  defs.Set("G", "g0");
+  defs.PushScope();
+  defs.Set("G", "g1");
+  defs.RaiseScope("G", "g2");
+  result = checkValue(defs, "G", "g0") && result;
+  defs.PopScope();
+  result = checkValue(defs, "G", "g2") && result;
+
+  // Raising to the top-most scope.
+  defs.RaiseScope("B", "b-raised");
+  defs.RaiseScope("F", 0);
+  result = checkValue(defs, "B", "b0") && result;
+
+  // Popping the scope restores the outer values.
+  defs.PopScope();
+  result = checkValue(defs, "A", "a0") && result;
+  result = checkValue(defs, "B", "b-raised") && result;
+  result = checkValue(defs, "D", 0) && result;
+  result = checkValue(defs, "E", 0) && result;
+  result = checkValue(defs, "F", 0) && result;
+  if(defs.LocalKeys().size() != 2)
+    {
+    printf("top-most scope has wrong local keys after pop\n");
+    result = false;
+    }
+  return result? 0 : 1;
+}
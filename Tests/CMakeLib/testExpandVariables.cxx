@@ -0,0 +1,97 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2014 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmake.h"
+#include "cmGlobalGenerator.h"
+#include "cmLocalGenerator.h"
+#include "cmMakefile.h"
+#include "cmSystemTools.h"
+
+#include <cmsys/auto_ptr.hxx>
+
+struct test_pair
+{
+  const char* in;
+  const char* out;
+};
+
+static test_pair const pairs[] = {
+  {"plain argument", "plain argument"},
+  {"${A}", "a"},
+  {"x${A}y${B}z", "xaybz"},
+  {"${${NAME}}", "a"},
+  {"${UNDEFINED}", ""},
+  {"a\\;b", "a\\;b"},
+  {"tab\\tend", "tab\tend"},
+  {"@A@", "@A@"},
+  {0,0}
+};
+
+// Expand each string many times and report the throughput.
+static void benchmark(cmMakefile* mf, const char* name, const char* in)
+{
+  int const count = 100000;
+  std::string const input = in;
+  std::string value;
+  double start = cmSystemTools::GetTime();
+  for(int i=0; i < count; ++i)
+    {
+    value = input;
+    mf->ExpandVariablesInString(value, false, false, false, "bench", 1,
+                                false, false);
+    }
+  double elapsed = cmSystemTools::GetTime() - start;
+  if(elapsed <= 0)
+    {
+    elapsed = 1e-9;
+    }
+  printf("%-10s %10.0f expansions/s\n", name, count / elapsed);
+}
+
+int testExpandVariables(int, char*[])
+{
+  int result = 0;
+  cmake cm;
+  cmGlobalGenerator* gg = new cmGlobalGenerator;
+  gg->SetCMakeInstance(&cm);
+  cm.SetGlobalGenerator(gg);
+  cmsys::auto_ptr<cmLocalGenerator> lg(gg->CreateLocalGenerator());
+  cmMakefile* mf = lg->GetMakefile();
+  std::string cwd = cmSystemTools::GetCurrentWorkingDirectory();
+  mf->SetHomeDirectory(cwd);
+  mf->SetHomeOutputDirectory(cwd);
+  mf->SetStartDirectory(cwd);
+  mf->SetStartOutputDirectory(cwd);
+  mf->SetPolicy(cmPolicies::CMP0053, cmPolicies::NEW);
+
+  mf->AddDefinition("A", "a");
+  mf->AddDefinition("B", "b");
+  mf->AddDefinition("NAME", "A");
+
+  for(test_pair const* p = pairs; p->in; ++p)
+    {
+    std::string value = p->in;
+    mf->ExpandVariablesInString(value, false, false, false, "test", 1,
+                                false, false);
+    if(value != p->out)
+      {
+      printf("expanding [%s]: expected [%s], got [%s]\n",
+             p->in, p->out, value.c_str());
+      result = 1;
+      }
+    }
+
+  benchmark(mf, "plain", "some/path/to/a/source/file.cxx");
+  benchmark(mf, "single", "${A}");
+  benchmark(mf, "mixed", "${A}/path/${B}/file-${NAME}.cxx");
+  benchmark(mf, "nested", "${${NAME}}${${NAME}}${${NAME}}");
+  return result;
+}
@@ -96,5 +96,42 @@ int testGeneratedFileStream(int, char*[])
   cmSystemTools::RemoveFile(file3tmp.c_str());
   cmSystemTools::RemoveFile(file4tmp.c_str());
 
+  // Test copy-if-different with content held in memory.
+  std::string file5 = "generatedFile5";
+  std::string file5tmp = file5 + ".tmp";
+  const char* contents[] =
+    {
+    "This is generated file 5\n", // new file
+    "This is generated file 5\n", // unchanged
+    "This is Generated File 5\n", // same length
+    "This is generated file 5 and more\n", // longer
+    "", // empty
+    0
+    };
+  for(const char** c = contents; *c; ++c)
+    {
+    gm.Open(file5.c_str());
+    gm.SetCopyIfDifferent(true);
+    gm << *c;
+    gm.Close();
+    std::string actual;
+    cmsys::ifstream fin(file5.c_str());
+    char ch;
+    while(fin.get(ch))
+      {
+      actual += ch;
+      }
+    if(actual != *c)
+      {
+      cmFailed("Copy-if-different did not produce content: ", *c);
+      }
+    if(cmSystemTools::FileExists(file5tmp.c_str()))
+      {
+      cmFailed("Copy-if-different left temporary file: ", file5tmp.c_str());
+      }
+    }
+  cmSystemTools::RemoveFile(file5.c_str());
+  cmSystemTools::RemoveFile(file5tmp.c_str());
+
   return failed;
 }
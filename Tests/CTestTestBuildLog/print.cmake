@@ -0,0 +1,3 @@
+# Print the recorded build log as a build command would.
+file(READ "${CMAKE_CURRENT_LIST_DIR}/build.log" log)
+message("${log}")
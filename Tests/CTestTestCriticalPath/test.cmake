@@ -0,0 +1,24 @@
+list(APPEND EXPECTED_OUTPUT
+  initialization
+  expensive1
+  expensive2
+  single
+  cheap1
+  cheap2
+  cheap3
+)
+
+
+if("${TEST_NAME}" STREQUAL "initialization")
+  file(WRITE ${TEST_OUTPUT_FILE} "${TEST_NAME}")
+
+elseif("${TEST_NAME}" STREQUAL "verification")
+  file(READ ${TEST_OUTPUT_FILE} ACTUAL_OUTPUT)
+  if(NOT "${ACTUAL_OUTPUT}" STREQUAL "${EXPECTED_OUTPUT}")
+    message(FATAL_ERROR "Actual test order [${ACTUAL_OUTPUT}] differs from expected test order [${EXPECTED_OUTPUT}]")
+  endif()
+
+else()
+  file(APPEND ${TEST_OUTPUT_FILE} ";${TEST_NAME}")
+
+endif()
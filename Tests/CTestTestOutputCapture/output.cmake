@@ -0,0 +1,21 @@
+# Print lines of 64 bytes each so that the head of the captured output
+# ends after line 32.
+set(dots "...............................................................")
+function(print_line prefix suffix)
+  string(LENGTH "${prefix}${suffix}" length)
+  math(EXPR length "63 - ${length}")
+  string(SUBSTRING "${dots}" 0 ${length} pad)
+  message("${prefix}${pad}${suffix}")
+endfunction()
+
+foreach(i RANGE 1 2000)
+  if(i EQUAL 32)
+    print_line("line ${i}: " "SPAN_FIRST")
+  elseif(i EQUAL 33)
+    print_line("SPAN_SECOND line ${i}: " "")
+  elseif(i EQUAL 1000)
+    print_line("line ${i}: MIDDLE_MARKER" "")
+  else()
+    print_line("line ${i}: some test output" "")
+  endif()
+endforeach()
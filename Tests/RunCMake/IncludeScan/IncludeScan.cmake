@@ -0,0 +1,29 @@
+# Read the include scan files of the build tree.  Sets
+#   db      = content of the database, empty if it does not exist
+#   targets = names of the files of the targets in IncludeScan.d
+set(dir "${RunCMake_TEST_BINARY_DIR}/CMakeFiles")
+set(db "")
+if(EXISTS "${dir}/IncludeScan.db")
+  file(READ "${dir}/IncludeScan.db" db)
+endif()
+file(GLOB targets RELATIVE "${dir}/IncludeScan.d" "${dir}/IncludeScan.d/*")
+list(SORT targets)
+
+# Check that the database has the given number of entries for a header.
+# Headers found in a relative include directory have relative paths.
+macro(check_entries header expect)
+  string(REGEX MATCHALL "\n([^\n]*/)?include/${header}\n" entries "${db}")
+  list(LENGTH entries n)
+  if(NOT n EQUAL ${expect})
+    set(msg "IncludeScan.db has ${n} entries for ${header}, not ${expect}:")
+    set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}${msg}\n${db}\n")
+  endif()
+endmacro()
+
+# Check the names of the files of the targets.
+macro(check_targets)
+  if(NOT "${targets}" STREQUAL "${ARGN}")
+    set(msg "IncludeScan.d has\n  ${targets}\nnot\n  ${ARGN}")
+    set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}${msg}\n")
+  endif()
+endmacro()
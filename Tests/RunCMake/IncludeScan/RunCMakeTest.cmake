@@ -0,0 +1,44 @@
+include(RunCMake)
+
+# Use a single build tree for the whole sequence.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/SharedHeader-build)
+set(RunCMake_TEST_NO_CLEAN 1)
+file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+set(inc "${RunCMake_TEST_BINARY_DIR}/include")
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/a.c"
+  "#include <shared.h>\nint a(void) { return 0; }\n")
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/b.c"
+  "#include <shared.h>\nint b(void) { return 0; }\n")
+# The scanner does not evaluate conditions so gone.h is a dependency.
+set(gone "#if 0\n#include <gone.h>\n#endif\n")
+file(WRITE "${inc}/shared.h" "#include <stale.h>\n${gone}")
+file(WRITE "${inc}/stale.h" "/* stale */\n")
+file(WRITE "${inc}/gone.h" "/* gone */\n")
+# Scan results are saved only for files not modified in the last seconds.
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 3)
+run_cmake(SharedHeader)
+run_cmake_command(SharedHeader-build1 ${CMAKE_COMMAND} --build .)
+run_cmake_command(SharedHeader-build2 ${CMAKE_COMMAND} --build .)
+
+# Stop including stale.h but keep it.
+file(WRITE "${inc}/shared.h" "${gone}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 3)
+run_cmake_command(SharedHeader-build3 ${CMAKE_COMMAND} --build .)
+
+# Remove gone.h before the results of the last build are merged.
+file(REMOVE "${inc}/gone.h")
+run_cmake_command(SharedHeader-build4 ${CMAKE_COMMAND} --build .)
+
+# Include enough new headers to double the number of entries.
+set(new "")
+foreach(n 1 2 3 4 5 6 7 8)
+  file(WRITE "${inc}/new${n}.h" "/* new${n} */\n")
+  set(new "${new}#include <new${n}.h>\n")
+endforeach()
+file(WRITE "${inc}/shared.h" "${new}${gone}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 3)
+run_cmake_command(SharedHeader-build5 ${CMAKE_COMMAND} --build .)
+run_cmake_command(SharedHeader-build6 ${CMAKE_COMMAND} --build .)
+unset(RunCMake_TEST_BINARY_DIR)
+unset(RunCMake_TEST_NO_CLEAN)
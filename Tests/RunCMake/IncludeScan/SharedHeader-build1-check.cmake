@@ -0,0 +1,8 @@
+include(${RunCMake_SOURCE_DIR}/IncludeScan.cmake)
+
+# Each target saved its scan results.  They are merged only by the
+# next build.
+check_targets("CMakeFiles_sa.dir.scan;CMakeFiles_sb.dir.scan")
+if(NOT db STREQUAL "")
+  set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}IncludeScan.db exists.\n")
+endif()
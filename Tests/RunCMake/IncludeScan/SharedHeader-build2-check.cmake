@@ -0,0 +1,8 @@
+include(${RunCMake_SOURCE_DIR}/IncludeScan.cmake)
+
+# The database holds one entry for each header of both targets.  The
+# files of the targets are gone once merged.
+check_targets()
+check_entries(shared.h 1)
+check_entries(stale.h 1)
+check_entries(gone.h 1)
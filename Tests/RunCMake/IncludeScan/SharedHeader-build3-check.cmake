@@ -0,0 +1,7 @@
+include(${RunCMake_SOURCE_DIR}/IncludeScan.cmake)
+
+# Both targets rescanned shared.h and saved only its entry.  The
+# database is merged only by the next build.
+check_targets("CMakeFiles_sa.dir.scan;CMakeFiles_sb.dir.scan")
+check_entries(shared.h 1)
+check_entries(stale.h 1)
@@ -0,0 +1,10 @@
+include(${RunCMake_SOURCE_DIR}/IncludeScan.cmake)
+
+# The targets were scanned again for the removed header but found the
+# other headers in the database.  The entry of a header no target
+# reaches any more stays while the header exists.  The entry of the
+# removed header stays until the entries are checked.
+check_targets()
+check_entries(shared.h 1)
+check_entries(stale.h 1)
+check_entries(gone.h 1)
@@ -0,0 +1,5 @@
+include(${RunCMake_SOURCE_DIR}/IncludeScan.cmake)
+
+# Both targets saved the entries of the new headers.
+check_targets("CMakeFiles_sa.dir.scan;CMakeFiles_sb.dir.scan")
+check_entries(new1.h 0)
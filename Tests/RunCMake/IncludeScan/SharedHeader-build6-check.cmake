@@ -0,0 +1,10 @@
+include(${RunCMake_SOURCE_DIR}/IncludeScan.cmake)
+
+# The number of entries doubled so all were checked when merging.  The
+# entry of the removed header is gone.
+check_targets()
+check_entries(shared.h 1)
+check_entries(stale.h 1)
+check_entries(gone.h 0)
+check_entries(new1.h 1)
+check_entries(new8.h 1)
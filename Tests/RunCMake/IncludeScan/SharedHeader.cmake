@@ -0,0 +1,4 @@
+enable_language(C)
+include_directories(${CMAKE_BINARY_DIR}/include)
+add_library(a STATIC ${CMAKE_BINARY_DIR}/a.c)
+add_library(b STATIC ${CMAKE_BINARY_DIR}/b.c)
@@ -0,0 +1,2 @@
+include(${RunCMake_SOURCE_DIR}/ListFileCounters.cmake)
+file(WRITE ${counters_file} "${parses};${hits}")
@@ -0,0 +1,2 @@
+set(count 0)
+include(${CMAKE_CURRENT_SOURCE_DIR}/counter.cmake)
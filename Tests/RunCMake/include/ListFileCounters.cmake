@@ -0,0 +1,28 @@
+# The list file cache counters are printed with --debug-output.  The
+# cases differ from the IncludeOnce case only in how they include a
+# file, so compare their counters to those of that case.
+set(counters_file ${RunCMake_BINARY_DIR}/IncludeOnce-counters.txt)
+set(counters_regex "Parsed ([0-9]+) list files, reused ([0-9]+) cached parses")
+if(actual_stderr MATCHES "${counters_regex}")
+  set(parses ${CMAKE_MATCH_1})
+  set(hits ${CMAKE_MATCH_2})
+else()
+  set(RunCMake_TEST_FAILED "No list file cache counters in the output.")
+endif()
+
+# Check the counters exceed those of the IncludeOnce case by the given
+# numbers of parses and hits.
+macro(check_counters more_parses more_hits)
+  if(NOT RunCMake_TEST_FAILED)
+    file(READ ${counters_file} once)
+    list(GET once 0 once_parses)
+    list(GET once 1 once_hits)
+    math(EXPR expect_parses "${once_parses} + ${more_parses}")
+    math(EXPR expect_hits "${once_hits} + ${more_hits}")
+    if(NOT parses EQUAL expect_parses OR NOT hits EQUAL expect_hits)
+      set(expect "${expect_parses} parses and ${expect_hits} hits")
+      set(actual "${parses} parses and ${hits} hits")
+      set(RunCMake_TEST_FAILED "Expected ${expect}, got ${actual}.")
+    endif()
+  endif()
+endmacro()
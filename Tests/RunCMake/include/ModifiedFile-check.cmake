@@ -0,0 +1,4 @@
+include(${RunCMake_SOURCE_DIR}/ListFileCounters.cmake)
+
+# The file modified before each of three inclusions is parsed each time.
+check_counters(2 0)
@@ -0,0 +1,7 @@
+foreach(v 1 2 3)
+  file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/modified.cmake "set(value ${v})\n")
+  include(${CMAKE_CURRENT_BINARY_DIR}/modified.cmake)
+  if(NOT value STREQUAL "${v}")
+    message(FATAL_ERROR "include read stale content: value=${value}")
+  endif()
+endforeach()
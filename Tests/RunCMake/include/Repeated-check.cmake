@@ -0,0 +1,4 @@
+include(${RunCMake_SOURCE_DIR}/ListFileCounters.cmake)
+
+# The file included three times is parsed once.
+check_counters(0 2)
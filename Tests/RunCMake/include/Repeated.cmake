@@ -0,0 +1,7 @@
+set(count 0)
+foreach(i 1 2 3)
+  include(${CMAKE_CURRENT_SOURCE_DIR}/counter.cmake)
+endforeach()
+if(NOT count EQUAL 3)
+  message(FATAL_ERROR "counter.cmake included ${count} times, expected 3")
+endif()
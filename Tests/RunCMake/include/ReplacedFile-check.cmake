@@ -0,0 +1,5 @@
+include(${RunCMake_SOURCE_DIR}/ListFileCounters.cmake)
+
+# The file replaced after its time stamp became trusted is parsed again.
+# It is reused when included again unchanged.
+check_counters(1 1)
@@ -0,0 +1,13 @@
+set(file ${CMAKE_CURRENT_BINARY_DIR}/replaced.cmake)
+file(WRITE ${file} "set(value 1)\n")
+# Let the file become old enough for its time stamp to be trusted.
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 3)
+include(${file})
+# Replace it with content of the same size.
+file(WRITE ${file}.tmp "set(value 2)\n")
+file(RENAME ${file}.tmp ${file})
+include(${file})
+if(NOT value STREQUAL "2")
+  message(FATAL_ERROR "include read stale content: value=${value}")
+endif()
+include(${file})
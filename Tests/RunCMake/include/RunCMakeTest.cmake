@@ -5,3 +5,11 @@ run_cmake(EmptyStringOptional)
 run_cmake(CMP0024-WARN)
 run_cmake(CMP0024-NEW)
 run_cmake(ExportExportInclude)
+
+# Check the list file cache counters printed with --debug-output.
+set(RunCMake_TEST_OPTIONS --debug-output)
+run_cmake(IncludeOnce)
+run_cmake(ModifiedFile)
+run_cmake(Repeated)
+run_cmake(ReplacedFile)
+unset(RunCMake_TEST_OPTIONS)